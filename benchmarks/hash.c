@@ -0,0 +1,100 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+/*
+    Hash function benchmark.
+
+    gcc -std=gnu11 -O3 benchmarks/hash.c -Iinclude -Ideps/include
+        -Ldeps/lib/SDL2 -lSDL2main -lSDL2 -o hash_benchmark
+*/
+
+#include "lumina/math/hash.h"
+
+
+#define ITERATIONS 2000000
+
+static volatile lm_uint64 sink;
+
+static double now() {
+    return (double)SDL_GetPerformanceCounter() / (double)SDL_GetPerformanceFrequency();
+}
+
+static void bench_string(size_t len) {
+    char *str = malloc(len + 1);
+    for (size_t i = 0; i < len; i++) str[i] = 'a' + (i * 7) % 26;
+    str[len] = '\0';
+
+    // Touch one byte per iteration so the hash can't be hoisted out
+    double start = now();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        str[i % len] ^= 1;
+        sink += lm_fnv1a(str);
+    }
+    double fnv = now() - start;
+
+    start = now();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        str[i % len] ^= 1;
+        sink += lm_hash_string(str);
+    }
+    double wy = now() - start;
+
+    start = now();
+    for (size_t i = 0; i < ITERATIONS; i++) {
+        str[i % len] ^= 1;
+        sink += lm_hash_bytes(str, len, 0);
+    }
+    double wy_len = now() - start;
+
+    printf(
+        "%5zu bytes   lm_fnv1a %7.2f ns   lm_hash_string %7.2f ns   lm_hash_bytes %7.2f ns\n",
+        len,
+        fnv * 1e9 / ITERATIONS,
+        wy * 1e9 / ITERATIONS,
+        wy_len * 1e9 / ITERATIONS
+    );
+
+    free(str);
+}
+
+static void bench_pair() {
+    double start = now();
+    for (lm_uint64 i = 0; i < ITERATIONS; i++) sink += lm_u64cantor(i, sink);
+    double cantor = now() - start;
+
+    start = now();
+    for (lm_uint64 i = 0; i < ITERATIONS; i++) sink += lm_hash_combine(i, sink);
+    double combine = now() - start;
+
+    start = now();
+    for (lm_uint64 i = 0; i < ITERATIONS; i++) sink += lm_u64mix(i ^ sink);
+    double mix = now() - start;
+
+    printf(
+        "integers    lm_u64cantor %6.2f ns   lm_hash_combine %6.2f ns   lm_u64mix %6.2f ns\n",
+        cantor * 1e9 / ITERATIONS,
+        combine * 1e9 / ITERATIONS,
+        mix * 1e9 / ITERATIONS
+    );
+}
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    size_t lengths[] = {8, 16, 32, 64, 256, 4096};
+
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+        bench_string(lengths[i]);
+
+    bench_pair();
+
+    return 0;
+}
@@ -19,6 +19,7 @@ INCLUDE_PATH = BASE_PATH / "include"
 EXAMPLES_PATH = BASE_PATH / "examples"
 
 BUILD_FOR_WEB = "web" in sys.argv
+BUILD_PACK = "pack" in sys.argv
 
 
 if os.path.exists(BUILD_PATH):
@@ -147,13 +148,19 @@ else:
            shutil.copyfile(BASE_PATH / "deps" / "bin" / "SDL2_ttf" / "SDL2_ttf.dll", BUILD_PATH / "SDL2_ttf.dll")
            shutil.copyfile(BASE_PATH / "deps" / "bin" / "SDL2_image" / "SDL2_image.dll", BUILD_PATH / "SDL2_image.dll")
 
-        os.mkdir(BUILD_PATH / "assets")
-        for *_, files in os.walk(EXAMPLES_PATH / "assets"):
-            for file in files:
-                shutil.copyfile(
-                    EXAMPLES_PATH / "assets" / file,
-                    BUILD_PATH / "assets" / file
-                )
+        if BUILD_PACK:
+            sys.path.insert(0, str(BASE_PATH))
+            from pack import pack_directory
+            pack_directory(EXAMPLES_PATH / "assets", BUILD_PATH / "assets.lmpack")
+
+        else:
+            os.mkdir(BUILD_PATH / "assets")
+            for *_, files in os.walk(EXAMPLES_PATH / "assets"):
+                for file in files:
+                    shutil.copyfile(
+                        EXAMPLES_PATH / "assets" / file,
+                        BUILD_PATH / "assets" / file
+                    )
 
         if IS_WIN:
             result = subprocess.run(binary)
@@ -84,6 +84,7 @@ int main(int argc, char **argv) {
     game_def.on_ready = on_ready;
     game_def.on_render = on_render;
     game_def.target_fps = 165;
+    game_def.frame_pacing = lmClockPacing_PRECISE;
 
     lmGame *game = lmGame_new(game_def);
 
@@ -17,6 +17,7 @@
 void movement_system(lm_uint64 entity_id, lmComponent **comps, size_t comps_size, void *user_context) {
     lmTransform *transform;
     lmVector2 *velocity;
+    lmTransform *previous;
 
     for (size_t i = 0; i < comps_size; i++) {
         lmComponent *comp = comps[i];
@@ -28,9 +29,16 @@ void movement_system(lm_uint64 entity_id, lmComponent **comps, size_t comps_size
             case 2:
                 velocity = comp->data;
                 break;
+
+            case 4:
+                previous = comp->data;
+                break;
         }
     }
 
+    // Keep the state before this tick to interpolate from when rendering
+    *previous = *transform;
+
     transform->position = lmVector2_add(transform->position, *velocity);
     transform->rotation += ((float)(entity_id % 2) - 0.5) * 2.5;
 }
@@ -72,24 +80,43 @@ void bounce_system(lm_uint64 entity_id, lmComponent **comps, size_t comps_size,
 
 void sprite_render_system(lm_uint64 entity_id, lmComponent **comps, size_t comps_size, void *user_context) {
     lmGame *game = (lmGame *)user_context;
-    lmTransform *transform;
+    lmTransform *current;
     lmTexture *texture;
+    lmTransform *previous;
 
     for (size_t i = 0; i < comps_size; i++) {
         lmComponent *comp = comps[i];
         switch (comp->id) {
             case 1:
-                transform = comp->data;
+                current = comp->data;
                 break;
 
             case 3:
                 texture = comp->data;
                 break;
+
+            case 4:
+                previous = comp->data;
+                break;
         }
     }
 
+    // The simulation ticks slower than we render, draw in between the last
+    // two ticks so movement stays smooth.
+    float alpha = (float)game->alpha;
+    lmTransform interpolated = *current;
+    interpolated.position = lmVector2_add(
+        previous->position,
+        lmVector2_mul(lmVector2_sub(current->position, previous->position), alpha)
+    );
+    interpolated.rotation = previous->rotation + (current->rotation - previous->rotation) * alpha;
+    lmTransform *transform = &interpolated;
+
+    // The texture may have been evicted since the component was made
+    SDL_Texture *sdl_texture = lmResource_use_texture(game, texture);
+
     int texture_width, texture_height;
-    SDL_QueryTexture(texture->sdl_texture, NULL, NULL, &texture_width, &texture_height);
+    SDL_QueryTexture(sdl_texture, NULL, NULL, &texture_width, &texture_height);
 
     float width = texture_width * transform->scale.x;
     float height = texture_height * transform->scale.y;
@@ -105,16 +132,16 @@ void sprite_render_system(lm_uint64 entity_id, lmComponent **comps, size_t comps
 
     float x = transform->position.x / 1280.0;
     float x0 = x * 2.0 - 1.0;
-    float alpha = x0 * x0 * x0 * x0 - 2.0 * (x0 * x0) + 1.0;
+    float fade = x0 * x0 * x0 * x0 - 2.0 * (x0 * x0) + 1.0;
 
     float h = entity_id % 256;
     lmColor color = lmColor_from_hsv((lmColor){h, 255, 255});
-    SDL_SetTextureColorMod(texture->sdl_texture, color.r, color.g, color.b);
-    SDL_SetTextureAlphaMod(texture->sdl_texture, dclamp(alpha, 0.0, 1.0) * 255);
+    SDL_SetTextureColorMod(sdl_texture, color.r, color.g, color.b);
+    SDL_SetTextureAlphaMod(sdl_texture, dclamp(fade, 0.0, 1.0) * 255);
 
     SDL_RenderCopyExF(
         game->window->sdl_renderer,
-        texture->sdl_texture,
+        sdl_texture,
         NULL,
         &dest_rect,
         transform->rotation,
@@ -130,7 +157,8 @@ void on_ready(lmGame *game) {
         LM_VERSION_MAJOR, LM_VERSION_MINOR, LM_VERSION_PATCH
     );
 
-    lmTexture *texture = lmTexture_from_png(game->window, "assets/gem.png");
+    lmResource_load_texture(game, "assets/gem.png");
+    lmTexture *texture = lmResource_get_texture(game, "assets/gem.png");
 
     lm_uint64 start = SDL_GetPerformanceCounter();
 
@@ -148,11 +176,13 @@ void on_ready(lmGame *game) {
         lmECS_add_component(game->ecs, ball, 2, &velocity, sizeof(lmVector2));
 
         lmECS_add_component_p(game->ecs, ball, 3, texture);
+
+        lmECS_add_component(game->ecs, ball, 4, &transform, sizeof(lmTransform));
     }
 
-    lmECS_add_system(game->ecs, "movement", movement_system, (lm_uint64[]){1, 2}, 2, NULL);
+    lmECS_add_system(game->ecs, "movement", movement_system, (lm_uint64[]){1, 2, 4}, 3, NULL);
     lmECS_add_system(game->ecs, "bounce", bounce_system, (lm_uint64[]){1, 2}, 2, NULL);
-    lmECS_add_system(game->ecs, "sprite_render", sprite_render_system, (lm_uint64[]){1, 3}, 2, game);
+    lmECS_add_system(game->ecs, "sprite_render", sprite_render_system, (lm_uint64[]){1, 3, 4}, 3, game);
 
     lm_uint64 end = SDL_GetPerformanceCounter();
     double elapsed = (double)end / game->clock->frequency - (double)start / game->clock->frequency;
@@ -160,30 +190,33 @@ void on_ready(lmGame *game) {
     printf("ECS setup: %fms\n", elapsed * 1000.0);
 }
 
+void on_update(lmGame *game) {
+    // Velocities are in pixels per tick, the simulation runs at a fixed
+    // tick rate so the speed doesn't depend on the frame rate.
+    lmECS_run_system_by_id(game->ecs, LM_SID("movement"));
+    lmECS_run_system_by_id(game->ecs, LM_SID("bounce"));
+}
+
 void on_render(lmGame *game) {
     lm_uint64 start = SDL_GetPerformanceCounter();
 
-    lmECS_run_system(game->ecs, "movement");
-    lmECS_run_system(game->ecs, "bounce");
+    lmECS_run_system_by_id(game->ecs, LM_SID("sprite_render"));
 
     lm_uint64 end = SDL_GetPerformanceCounter();
-    double systems_elapsed = (double)end / game->clock->frequency - (double)start / game->clock->frequency;
-
-    start = SDL_GetPerformanceCounter();
-
-    lmECS_run_system(game->ecs, "sprite_render");
-
-    end = SDL_GetPerformanceCounter();
     double render_elapsed = (double)end / game->clock->frequency - (double)start / game->clock->frequency;
-    //printf("Systems: %fms - Render:  %fms\n", systems_elapsed * 1000.0, render_elapsed * 1000.0);
+    //printf("Render:  %fms\n", render_elapsed * 1000.0);
 }
 
 int main(int argc, char **argv) {
     lmGameDef game_def = lmGameDef_default;
     game_def.window_title = "Basic Lumina Game Example";
     game_def.on_ready = on_ready;
+    game_def.on_update = on_update;
     game_def.on_render = on_render;
     game_def.target_fps = 165;
+    game_def.frame_pacing = lmClockPacing_PRECISE;
+    game_def.fixed_timestep = true;
+    game_def.tick_rate = 60;
 
     lmGame *game = lmGame_new(game_def);
 
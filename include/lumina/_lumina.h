@@ -41,6 +41,7 @@
 
 #include "lumina/core/types.h"
 #include "lumina/core/platform.h"
+#include "lumina/core/memory.h"
 
 
 #if defined(__EMSCRIPTEN__)
@@ -49,12 +50,42 @@
 #endif
 
 
+/*
+    Memory tag the allocation macros below use. Engine source files define
+    this before including any header to attribute their allocations.
+*/
+#ifndef LM_MEMORY_TAG
+    #define LM_MEMORY_TAG lmMemoryTag_GENERAL
+#endif
+
 /**
  * @brief Allocate on HEAP.
  * 
  * @param type Type
  */
-#define LM_NEW(type) ((type *)malloc(sizeof(type)))
+#define LM_NEW(type) ((type *)lm_malloc(sizeof(type), LM_MEMORY_TAG))
+
+/**
+ * @brief Allocate bytes on HEAP.
+ * 
+ * @param size Size in bytes
+ */
+#define LM_MALLOC(size) (lm_malloc((size), LM_MEMORY_TAG))
+
+/**
+ * @brief Reallocate memory on HEAP.
+ * 
+ * @param ptr Memory to reallocate
+ * @param size New size in bytes
+ */
+#define LM_REALLOC(ptr, size) (lm_realloc((ptr), (size), LM_MEMORY_TAG))
+
+/**
+ * @brief Free memory allocated with the macros above.
+ * 
+ * @param ptr Memory to free
+ */
+#define LM_FREE(ptr) (lm_free(ptr))
 
 
 #ifdef LM_WEB
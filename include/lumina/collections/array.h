@@ -26,7 +26,7 @@
  */
 typedef struct {
     size_t size; /**< Length of the array. */
-    size_t max; /**< Maximum size the array ever reached, this is basically the size of the array on HEAP. */
+    size_t max; /**< Number of elements the array can hold before it has to grow. */
     void **data; /**< Array of void pointers. */
 } lmArray;
 
@@ -0,0 +1,151 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_CONCURRENT_HASHMAP_H
+#define _LUMINA_CONCURRENT_HASHMAP_H
+
+#include "lumina/_lumina.h"
+
+
+/**
+ * @file collections/concurrent_hashmap.h
+ * 
+ * @brief Read-mostly hash map that is safe to share between threads.
+ */
+
+
+struct _lmConcurrentHashMapTable;
+
+/**
+ * @brief Hash map with lock-free reads and locked writes.
+ * 
+ * Every item lives in its own node that never moves, and the table is an
+ * array of node pointers that readers walk with atomic loads only. Writers
+ * serialize on a mutex and publish nodes and resized tables atomically.
+ * 
+ * Nodes and tables that are replaced or removed are not freed right away
+ * since a reader might still be looking at them. They are retired instead
+ * and freed by lmConcurrentHashMap_collect, which must be called at a point
+ * where no other thread is inside a get or holds an item pointer from one,
+ * such as between frames.
+ */
+typedef struct {
+    size_t elsize; /**< Size of an item in bytes. */
+    size_t cap; /**< Starting capacity. */
+    lm_uint64 (*hash_func)(void *item); /**< Hash function callback. */
+    int (*compare_func)(void *a, void *b); /**< Key comparison callback, NULL to compare by hash only. */
+
+    size_t count; /**< Number of items in the map. */
+    size_t deleted; /**< Number of deleted slots (tombstones). */
+    size_t growat; /**< Grow when count + deleted reaches this. */
+    bool oom; /**< Set if the last set failed to allocate memory. */
+
+    struct _lmConcurrentHashMapTable *table; /**< Current table, swapped atomically on resize. */
+    void *retired_nodes; /**< Nodes waiting to be freed. */
+    struct _lmConcurrentHashMapTable *retired_tables; /**< Tables waiting to be freed. */
+    SDL_mutex *write_lock; /**< Serializes writers. */
+} lmConcurrentHashMap;
+
+/**
+ * @brief Create new concurrent hash map.
+ * 
+ * @param item_size Size of the entries stored in the hash map
+ * @param cap Starting capacity of the hash map
+ * @param hash_func Hash function callback
+ * @param compare_func Comparison callback returning 0 if the keys of two
+ *                     entries are equal. If `NULL`, entries with the same
+ *                     hash are treated as the same entry.
+ * @return lmConcurrentHashMap *
+ */
+lmConcurrentHashMap *lmConcurrentHashMap_new(
+    size_t item_size,
+    size_t cap,
+    lm_uint64 (*hash_func)(void *item),
+    int (*compare_func)(void *a, void *b)
+);
+
+/**
+ * @brief Free concurrent hash map.
+ * 
+ * No other thread may be using the map.
+ * 
+ * @param hashmap Hash map to free
+ */
+void lmConcurrentHashMap_free(lmConcurrentHashMap *hashmap);
+
+/**
+ * @brief Remove all entries in the hash map.
+ * 
+ * The removed entries are retired, not freed.
+ * 
+ * @param hashmap Hash map to clear
+ */
+void lmConcurrentHashMap_clear(lmConcurrentHashMap *hashmap);
+
+/**
+ * @brief Get entry from key. Lock-free.
+ * 
+ * The returned item stays valid until it is removed or replaced and the next
+ * lmConcurrentHashMap_collect after that.
+ * 
+ * @param hashmap Hash map
+ * @param key Key
+ * @return void *
+ */
+void *lmConcurrentHashMap_get(lmConcurrentHashMap *hashmap, void *key);
+
+/**
+ * @brief Set entry.
+ * 
+ * Returns the replaced item or `NULL`. The replaced item stays valid until
+ * the next lmConcurrentHashMap_collect.
+ * 
+ * @param hashmap Hash map
+ * @param item Entry item
+ * @return void *
+ */
+void *lmConcurrentHashMap_set(lmConcurrentHashMap *hashmap, void *item);
+
+/**
+ * @brief Remove entry from hash map with key.
+ * 
+ * Returns the removed item or `NULL`. The removed item stays valid until
+ * the next lmConcurrentHashMap_collect.
+ * 
+ * @param hashmap Hash map
+ * @param key Key
+ * @return void *
+ */
+void *lmConcurrentHashMap_remove(lmConcurrentHashMap *hashmap, void *key);
+
+/**
+ * @brief Iterate over hash map entries.
+ * 
+ * Entries set or removed by other threads during iteration may or may not
+ * be visited, and a resize in between can visit entries twice.
+ * 
+ * @param hashmap Hash map
+ * @param index Pointer to index counter
+ * @param item Pointer to entry pointer
+ * @return bool
+ */
+bool lmConcurrentHashMap_iter(lmConcurrentHashMap *hashmap, size_t *index, void **item);
+
+/**
+ * @brief Free retired items and tables.
+ * 
+ * Only call this when no other thread is reading from the map.
+ * 
+ * @param hashmap Hash map
+ */
+void lmConcurrentHashMap_collect(lmConcurrentHashMap *hashmap);
+
+
+#endif
@@ -21,33 +21,51 @@
  */
 
 
-typedef struct {
-    lm_uint64 hash: 48;
-    lm_uint64 dib: 16;
-} lmHashMapBucket;
+/*
+    Control byte values. A full slot stores the low 7 bits of its hash, so
+    the high bit tells empty and deleted slots apart from full ones.
+*/
+#define LM_HASHMAP_CTRL_EMPTY ((lm_uint8)0x80)
+#define LM_HASHMAP_CTRL_DELETED ((lm_uint8)0xFE)
+
+// Number of control bytes probed at once.
+#define LM_HASHMAP_GROUP_WIDTH 16
+
+// Default load factors to grow above and shrink below.
+#define LM_HASHMAP_MAX_LOAD 0.6
+#define LM_HASHMAP_MIN_LOAD 0.1
 
 
 /**
  * @brief Hash map.
+ * 
+ * Open addressing table in the style of Swiss tables: a separate array of
+ * one-byte control tags is probed a group of 16 slots at a time using SSE2 or
+ * NEON where available. On a tag match the stored full hash is checked
+ * first, and the comparison callback is only called when that matches too.
  */
 typedef struct {
-    size_t elsize;
-    size_t cap;
-    lm_uint64 (*hash_func)(void *item);
-
-    size_t count;
-    bool oom;
-
-    size_t bucketsz;
-    size_t nbuckets;
-    size_t mask;
-    size_t growat;
-    size_t shrinkat;
-    lm_uint8 growpower;
-
-    void *buckets;
-    void *spare;
-    void *edata;
+    size_t elsize; /**< Size of an item in bytes. */
+    size_t cap; /**< Starting capacity, the map never shrinks below this. */
+    lm_uint64 (*hash_func)(void *item); /**< Hash function callback. */
+    int (*compare_func)(void *a, void *b); /**< Key comparison callback, NULL to compare by hash only. */
+
+    size_t count; /**< Number of items in the map. */
+    size_t deleted; /**< Number of deleted slots (tombstones). */
+    bool oom; /**< Set if the last set or remove failed to allocate memory. */
+
+    size_t nbuckets; /**< Number of slots, always a power of 2. */
+    size_t mask; /**< nbuckets - 1. */
+    size_t growat; /**< Grow when count + deleted reaches this. */
+    size_t shrinkat; /**< Shrink when count drops to this. */
+    lm_uint8 growpower; /**< Growth factor as a power of 2. */
+    double max_load; /**< Load factor to grow above. */
+    double min_load; /**< Load factor to shrink below. */
+
+    lm_uint64 *hashes; /**< Full hash of each slot, so probes and resizes don't call hash_func. */
+    lm_uint8 *ctrl; /**< Control bytes, nbuckets + LM_HASHMAP_GROUP_WIDTH with the first group mirrored at the end. */
+    void *slots; /**< Item storage, nbuckets * elsize. */
+    void *spare; /**< Scratch item used to return replaced or removed items. */
 } lmHashMap;
 
 /**
@@ -56,12 +74,16 @@ typedef struct {
  * @param item_size Size of the entries stored in the hash map
  * @param cap Starting capacity of the hash map
  * @param hash_func Hash function callback
+ * @param compare_func Comparison callback returning 0 if the keys of two
+ *                     entries are equal. If `NULL`, entries with the same
+ *                     hash are treated as the same entry.
  * @return lmHashMap * 
  */
 lmHashMap *lmHashMap_new(
     size_t item_size,
     size_t cap,
-    lm_uint64 (*hash_func)(void *item)
+    lm_uint64 (*hash_func)(void *item),
+    int (*compare_func)(void *a, void *b)
 );
 
 /**
@@ -95,6 +117,54 @@ void *lmHashMap_get(lmHashMap *map, void *item);
  */
 void *lmHashMap_set(lmHashMap *map, void *item);
 
+/**
+ * @brief Set many entries at once.
+ * 
+ * The table is sized once up front and the entries are inserted in hash
+ * order, so loading a large batch never rehashes midway. Returns `false` if
+ * failed to allocate memory, in which case nothing is inserted.
+ * 
+ * @param hashmap Hash map
+ * @param items Array of entries
+ * @param count Number of entries
+ * @return bool
+ */
+bool lmHashMap_set_many(lmHashMap *hashmap, void *items, size_t count);
+
+/**
+ * @brief Grow the hash map so it can hold count entries without rehashing.
+ * 
+ * Returns `false` if failed to allocate memory.
+ * 
+ * @param hashmap Hash map
+ * @param count Number of entries
+ * @return bool
+ */
+bool lmHashMap_reserve(lmHashMap *hashmap, size_t count);
+
+/**
+ * @brief Shrink the hash map to the smallest size that holds its entries.
+ * 
+ * This can go below the starting capacity and also drops all tombstones.
+ * Returns `false` if failed to allocate memory, the map is left as is then.
+ * 
+ * @param hashmap Hash map
+ * @return bool
+ */
+bool lmHashMap_shrink_to_fit(lmHashMap *hashmap);
+
+/**
+ * @brief Set the load factors the hash map grows above and shrinks below.
+ * 
+ * Max load is clamped to [0.25, 0.875] and min load to [0, max load / 4].
+ * Defaults are LM_HASHMAP_MAX_LOAD and LM_HASHMAP_MIN_LOAD.
+ * 
+ * @param hashmap Hash map
+ * @param max_load Load factor to grow above
+ * @param min_load Load factor to shrink below
+ */
+void lmHashMap_set_load_factors(lmHashMap *hashmap, double max_load, double min_load);
+
 /**
  * @brief Remove entry from hash map with key.
  * 
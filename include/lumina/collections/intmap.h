@@ -0,0 +1,165 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_INTMAP_H
+#define _LUMINA_INTMAP_H
+
+#include "lumina/_lumina.h"
+#include "lumina/math/hash.h"
+
+
+/**
+ * @file collections/intmap.h
+ * 
+ * @brief Integer-keyed flat hash map.
+ */
+
+
+/**
+ * @brief Key value reserved to mark empty slots.
+ * 
+ * It can still be used as a key, it is just stored outside the table.
+ */
+#define LM_INTMAP_EMPTY_KEY ((lm_uint64)-1)
+
+
+/**
+ * @brief Hash map from unsigned 64-bit integers to unsigned 64-bit integers.
+ * 
+ * Linear probing over separate key and value arrays, so probes only walk
+ * the densely packed keys. Keys are hashed inline with lm_u64mix and removal
+ * shifts entries back instead of leaving tombstones.
+ * 
+ * Pointers can be stored as values with the `_ptr` variants.
+ */
+typedef struct {
+    lm_uint64 *keys; /**< Keys, LM_INTMAP_EMPTY_KEY for empty slots. */
+    lm_uint64 *values; /**< Values. */
+    size_t count; /**< Number of entries in the map. */
+    size_t cap; /**< Number of slots, always a power of 2. */
+    size_t mask; /**< cap - 1. */
+    size_t growat; /**< Grow when count reaches this. */
+    bool oom; /**< Set if the last set failed to allocate memory. */
+
+    bool has_empty_key; /**< Whether LM_INTMAP_EMPTY_KEY is in the map. */
+    lm_uint64 empty_key_value; /**< Value of LM_INTMAP_EMPTY_KEY. */
+} lmIntMap;
+
+/**
+ * @brief Create new integer map.
+ * 
+ * @param cap Starting capacity
+ * @return lmIntMap *
+ */
+lmIntMap *lmIntMap_new(size_t cap);
+
+/**
+ * @brief Free integer map.
+ * 
+ * @param map Map to free
+ */
+void lmIntMap_free(lmIntMap *map);
+
+/**
+ * @brief Remove all entries in the map.
+ * 
+ * @param map Map to clear
+ */
+void lmIntMap_clear(lmIntMap *map);
+
+/**
+ * @brief Set entry. Returns `false` if failed to allocate memory.
+ * 
+ * @param map Map
+ * @param key Key
+ * @param value Value
+ * @return bool
+ */
+bool lmIntMap_set(lmIntMap *map, lm_uint64 key, lm_uint64 value);
+
+/**
+ * @brief Remove entry. Returns `false` if the key was not in the map.
+ * 
+ * If removed during iteration, set counter back to 0.
+ * 
+ * @param map Map
+ * @param key Key
+ * @param value Pointer to write the removed value to, can be `NULL`
+ * @return bool
+ */
+bool lmIntMap_remove(lmIntMap *map, lm_uint64 key, lm_uint64 *value);
+
+/**
+ * @brief Iterate over entries.
+ * 
+ * @param map Map
+ * @param index Pointer to index counter
+ * @param key Pointer to write the key to
+ * @param value Pointer to write the value to
+ * @return bool
+ */
+bool lmIntMap_iter(lmIntMap *map, size_t *index, lm_uint64 *key, lm_uint64 *value);
+
+/**
+ * @brief Get entry. Returns `false` if the key is not in the map.
+ * 
+ * @param map Map
+ * @param key Key
+ * @param value Pointer to write the value to
+ * @return bool
+ */
+static inline bool lmIntMap_get(lmIntMap *map, lm_uint64 key, lm_uint64 *value) {
+    if (key == LM_INTMAP_EMPTY_KEY) {
+        *value = map->empty_key_value;
+        return map->has_empty_key;
+    }
+
+    size_t i = lm_u64mix(key) & map->mask;
+    while (true) {
+        lm_uint64 k = map->keys[i];
+
+        if (k == key) {
+            *value = map->values[i];
+            return true;
+        }
+
+        if (k == LM_INTMAP_EMPTY_KEY) return false;
+
+        i = (i + 1) & map->mask;
+    }
+}
+
+/**
+ * @brief Get pointer entry. Returns `NULL` if the key is not in the map.
+ * 
+ * @param map Map
+ * @param key Key
+ * @return void *
+ */
+static inline void *lmIntMap_get_ptr(lmIntMap *map, lm_uint64 key) {
+    lm_uint64 value;
+    if (!lmIntMap_get(map, key, &value)) return NULL;
+    return (void *)(uintptr_t)value;
+}
+
+/**
+ * @brief Set pointer entry. Returns `false` if failed to allocate memory.
+ * 
+ * @param map Map
+ * @param key Key
+ * @param ptr Pointer value
+ * @return bool
+ */
+static inline bool lmIntMap_set_ptr(lmIntMap *map, lm_uint64 key, void *ptr) {
+    return lmIntMap_set(map, key, (lm_uint64)(uintptr_t)ptr);
+}
+
+
+#endif
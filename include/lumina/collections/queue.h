@@ -0,0 +1,155 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_QUEUE_H
+#define _LUMINA_QUEUE_H
+
+#include "lumina/_lumina.h"
+
+
+/**
+ * @file collections/queue.h
+ * 
+ * @brief Bounded lock-free queues for passing data between threads.
+ */
+
+
+// Assumed cache line size, indices written by different threads are kept
+// this far apart so they don't false share.
+#define LM_CACHE_LINE_SIZE 64
+
+
+/**
+ * @brief Bounded single-producer single-consumer queue.
+ * 
+ * Only one thread may push and only one thread may pop at a time. Each side
+ * keeps a cached copy of the other side's index, so the shared indices are
+ * only touched when the cached one says the queue looks full or empty.
+ */
+typedef struct {
+    size_t elsize; /**< Size of an element in bytes. */
+    size_t cap; /**< Number of elements the queue can hold, a power of 2. */
+    size_t mask; /**< cap - 1. */
+    char *buffer; /**< Element storage. */
+    char _pad0[LM_CACHE_LINE_SIZE];
+
+    size_t head; /**< Next index to pop, written by the consumer. */
+    size_t cached_tail; /**< Consumer's copy of tail. */
+    char _pad1[LM_CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+
+    size_t tail; /**< Next index to push, written by the producer. */
+    size_t cached_head; /**< Producer's copy of head. */
+    char _pad2[LM_CACHE_LINE_SIZE - 2 * sizeof(size_t)];
+} lmSPSCQueue;
+
+/**
+ * @brief Create new SPSC queue.
+ * 
+ * @param elsize Size of an element in bytes
+ * @param cap Minimum capacity, rounded up to a power of 2
+ * @return lmSPSCQueue *
+ */
+lmSPSCQueue *lmSPSCQueue_new(size_t elsize, size_t cap);
+
+/**
+ * @brief Free SPSC queue.
+ * 
+ * @param queue Queue to free
+ */
+void lmSPSCQueue_free(lmSPSCQueue *queue);
+
+/**
+ * @brief Copy element to the queue. Returns `false` if the queue is full.
+ * 
+ * @param queue Queue
+ * @param elem Element to copy
+ * @return bool
+ */
+bool lmSPSCQueue_push(lmSPSCQueue *queue, const void *elem);
+
+/**
+ * @brief Copy the oldest element out of the queue. Returns `false` if the queue is empty.
+ * 
+ * @param queue Queue
+ * @param elem Pointer to copy the element to
+ * @return bool
+ */
+bool lmSPSCQueue_pop(lmSPSCQueue *queue, void *elem);
+
+/**
+ * @brief Number of elements in the queue.
+ * 
+ * Only a snapshot while the other side is running.
+ * 
+ * @param queue Queue
+ * @return size_t
+ */
+size_t lmSPSCQueue_size(lmSPSCQueue *queue);
+
+
+/**
+ * @brief Bounded multi-producer multi-consumer queue.
+ * 
+ * Any number of threads may push and pop. Each cell carries a sequence
+ * number that tells producers and consumers whose turn it is, so claiming a
+ * slot is a single compare-and-swap on the shared index.
+ * (Dmitry Vyukov's bounded MPMC queue)
+ */
+typedef struct {
+    size_t elsize; /**< Size of an element in bytes. */
+    size_t stride; /**< Size of a cell (sequence + element) in bytes. */
+    size_t cap; /**< Number of elements the queue can hold, a power of 2. */
+    size_t mask; /**< cap - 1. */
+    char *cells; /**< Cell storage. */
+    char _pad0[LM_CACHE_LINE_SIZE];
+
+    size_t enqueue_pos; /**< Next position to push to. */
+    char _pad1[LM_CACHE_LINE_SIZE - sizeof(size_t)];
+
+    size_t dequeue_pos; /**< Next position to pop from. */
+    char _pad2[LM_CACHE_LINE_SIZE - sizeof(size_t)];
+} lmMPMCQueue;
+
+/**
+ * @brief Create new MPMC queue.
+ * 
+ * @param elsize Size of an element in bytes
+ * @param cap Minimum capacity, rounded up to a power of 2
+ * @return lmMPMCQueue *
+ */
+lmMPMCQueue *lmMPMCQueue_new(size_t elsize, size_t cap);
+
+/**
+ * @brief Free MPMC queue.
+ * 
+ * @param queue Queue to free
+ */
+void lmMPMCQueue_free(lmMPMCQueue *queue);
+
+/**
+ * @brief Copy element to the queue. Returns `false` if the queue is full.
+ * 
+ * @param queue Queue
+ * @param elem Element to copy
+ * @return bool
+ */
+bool lmMPMCQueue_push(lmMPMCQueue *queue, const void *elem);
+
+/**
+ * @brief Copy the oldest element out of the queue. Returns `false` if the queue is empty.
+ * 
+ * @param queue Queue
+ * @param elem Pointer to copy the element to
+ * @return bool
+ */
+bool lmMPMCQueue_pop(lmMPMCQueue *queue, void *elem);
+
+
+#endif
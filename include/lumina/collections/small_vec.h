@@ -0,0 +1,117 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_SMALL_VEC_H
+#define _LUMINA_SMALL_VEC_H
+
+#include "lumina/_lumina.h"
+
+
+/**
+ * @file collections/small_vec.h
+ * 
+ * @brief Dynamically growing array with inline storage for short lists.
+ */
+
+
+/**
+ * @brief Declare a small vec of type with inline storage for n elements.
+ * 
+ * The first n elements live inside the struct itself and the storage only
+ * moves to the heap once more are pushed. There are no pointers into the
+ * struct, so small vecs can be copied around with memcpy.
+ * 
+ * Example:
+ * @code
+ * typedef LM_SMALL_VEC(lm_uint64, 4) lmIdList;
+ * 
+ * lmIdList ids;
+ * LM_SMALL_VEC_INIT(ids);
+ * LM_SMALL_VEC_PUSH(ids, 42);
+ * lm_uint64 first = LM_SMALL_VEC_DATA(ids)[0];
+ * LM_SMALL_VEC_FREE(ids);
+ * @endcode
+ */
+#define LM_SMALL_VEC(type, n)             \
+    struct {                              \
+        lm_uint32 size;                   \
+        lm_uint32 max;                    \
+        union {                           \
+            type inline_data[n];          \
+            type *heap;                   \
+        } storage;                        \
+    }
+
+/**
+ * @brief Number of elements the small vec holds inline.
+ */
+#define LM_SMALL_VEC_INLINE_CAP(vec) \
+    (sizeof((vec).storage.inline_data) / sizeof((vec).storage.inline_data[0]))
+
+/**
+ * @brief Initialize an empty small vec.
+ */
+#define LM_SMALL_VEC_INIT(vec) \
+    ((vec).size = 0, (vec).max = LM_SMALL_VEC_INLINE_CAP(vec))
+
+/**
+ * @brief Pointer to the elements of the small vec.
+ */
+#define LM_SMALL_VEC_DATA(vec)                           \
+    ((vec).max > LM_SMALL_VEC_INLINE_CAP(vec) ?          \
+        (vec).storage.heap : (vec).storage.inline_data)
+
+/**
+ * @brief Append value to the small vec. Evaluates to `false` if failed to allocate memory.
+ */
+#define LM_SMALL_VEC_PUSH(vec, value) ({                                   \
+    bool _lm_ok = true;                                                    \
+    if ((vec).size == (vec).max)                                           \
+        _lm_ok = _lm_small_vec_grow(                                       \
+            &(vec).storage, (vec).size, &(vec).max,                        \
+            sizeof((vec).storage.inline_data[0]),                          \
+            LM_SMALL_VEC_INLINE_CAP(vec)                                   \
+        );                                                                 \
+    if (_lm_ok) LM_SMALL_VEC_DATA(vec)[(vec).size++] = (value);            \
+    _lm_ok;                                                                \
+})
+
+/**
+ * @brief Free the heap storage of the small vec if it has any.
+ */
+#define LM_SMALL_VEC_FREE(vec) ({                          \
+    if ((vec).max > LM_SMALL_VEC_INLINE_CAP(vec))          \
+        LM_FREE((vec).storage.heap);                       \
+    LM_SMALL_VEC_INIT(vec);                                \
+})
+
+
+/**
+ * @brief Double the capacity of a full small vec, moving it to the heap if it is inline.
+ * 
+ * Used by LM_SMALL_VEC_PUSH.
+ * 
+ * @param storage Pointer to the storage union
+ * @param size Number of elements
+ * @param max Pointer to the capacity
+ * @param elsize Size of an element in bytes
+ * @param inline_cap Inline capacity
+ * @return bool
+ */
+bool _lm_small_vec_grow(
+    void *storage,
+    lm_uint32 size,
+    lm_uint32 *max,
+    size_t elsize,
+    size_t inline_cap
+);
+
+
+#endif
@@ -0,0 +1,129 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_VEC_H
+#define _LUMINA_VEC_H
+
+#include "lumina/_lumina.h"
+
+
+/**
+ * @file collections/vec.h
+ * 
+ * @brief Value-storing dynamically growing array implementation.
+ */
+
+
+/**
+ * @brief Value-storing dynamically growing array.
+ * 
+ * Unlike lmArray, elements are copied into one contiguous block instead of
+ * being stored as pointers. The block is aligned for any type and grows
+ * geometrically, so pointers into it are invalidated when it grows.
+ */
+typedef struct {
+    size_t elsize; /**< Size of an element in bytes. */
+    size_t size; /**< Number of elements. */
+    size_t max; /**< Number of elements the storage can hold. */
+    void *data; /**< Element storage. */
+} lmVec;
+
+/**
+ * @brief Access element at index as the given type.
+ */
+#define LM_VEC_AT(vec, type, index) (((type *)(vec)->data)[index])
+
+/**
+ * @brief Create new vec.
+ * 
+ * @param elsize Size of an element in bytes
+ * @return lmVec *
+ */
+lmVec *lmVec_new(size_t elsize);
+
+/**
+ * @brief Free vec.
+ * 
+ * @param vec Vec to free
+ */
+void lmVec_free(lmVec *vec);
+
+/**
+ * @brief Grow the storage so it can hold count elements. Returns `false` if failed to allocate memory.
+ * 
+ * @param vec Vec
+ * @param count Number of elements
+ * @return bool
+ */
+bool lmVec_reserve(lmVec *vec, size_t count);
+
+/**
+ * @brief Copy new element to the end. Returns the stored element or `NULL` if failed to allocate memory.
+ * 
+ * If elem is `NULL` the new element is zeroed.
+ * 
+ * @param vec Vec to append to
+ * @param elem Element to copy
+ * @return void *
+ */
+void *lmVec_push(lmVec *vec, const void *elem);
+
+/**
+ * @brief Copy many elements to the end at once. Returns `false` if failed to allocate memory.
+ * 
+ * @param vec Vec to append to
+ * @param elems Array of elements
+ * @param count Number of elements
+ * @return bool
+ */
+bool lmVec_append(lmVec *vec, const void *elems, size_t count);
+
+/**
+ * @brief Remove the last element. Returns `false` if the vec is empty.
+ * 
+ * @param vec Vec
+ * @param elem Pointer to copy the removed element to, can be `NULL`
+ * @return bool
+ */
+bool lmVec_pop(lmVec *vec, void *elem);
+
+/**
+ * @brief Remove element by index by moving the last element into its place. Returns `false` if out of bounds.
+ * 
+ * @note Order of the elements is not kept.
+ * 
+ * @param vec Vec
+ * @param index Index of element to remove
+ * @param elem Pointer to copy the removed element to, can be `NULL`
+ * @return bool
+ */
+bool lmVec_swap_remove(lmVec *vec, size_t index, void *elem);
+
+/**
+ * @brief Remove all elements, keeping the storage.
+ * 
+ * @param vec Vec
+ */
+void lmVec_clear(lmVec *vec);
+
+/**
+ * @brief Get pointer to element by index. Returns `NULL` if out of bounds.
+ * 
+ * @param vec Vec
+ * @param index Index
+ * @return void *
+ */
+static inline void *lmVec_get(lmVec *vec, size_t index) {
+    if (index >= vec->size) return NULL;
+    return (char *)vec->data + vec->elsize * index;
+}
+
+
+#endif
@@ -13,6 +13,7 @@
 
 #include "lumina/_lumina.h"
 #include "lumina/math/vector.h"
+#include "lumina/math/matrix.h"
 
 
 /**
@@ -27,7 +28,7 @@
  */
 typedef struct {
     lmVector2 position; /**< Position of the transform. */
-    float rotation; /**< Rotation of the transform as angle. */
+    float rotation; /**< Rotation of the transform in radians. */
     lmVector2 scale; /**< Scale of the transform. */
 } lmTransform;
 
@@ -40,5 +41,15 @@ static const lmTransform lmTransform_default = {
     LM_VEC2(1.0, 1.0)
 };
 
+/**
+ * @brief Get matrix of a transform.
+ * 
+ * @param transform Transform
+ * @return lmMatrix3x2
+ */
+static inline lmMatrix3x2 lmTransform_to_matrix(lmTransform transform) {
+    return lmMatrix3x2_from_trs(transform.position, transform.rotation, transform.scale);
+}
+
 
 #endif
\ No newline at end of file
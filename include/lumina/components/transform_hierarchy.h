@@ -0,0 +1,180 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_COMPONENTS_TRANSFORM_HIERARCHY_H
+#define _LUMINA_COMPONENTS_TRANSFORM_HIERARCHY_H
+
+#include "lumina/_lumina.h"
+#include "lumina/collections/vec.h"
+#include "lumina/collections/intmap.h"
+#include "lumina/components/transform.h"
+#include "lumina/math/matrix.h"
+
+
+/**
+ * @file components/transform_hierarchy.h
+ * 
+ * @brief Parent-child transform relationships and world matrices.
+ */
+
+
+/**
+ * @brief Parent value of transforms without a parent.
+ */
+#define LM_TRANSFORM_ROOT ((lm_uint64)-1)
+
+/**
+ * @brief Parent index of transforms without a parent.
+ */
+#define LM_TRANSFORM_NO_INDEX ((lm_uint32)-1)
+
+
+/**
+ * @brief Transform of one entity in the hierarchy.
+ */
+typedef struct {
+    lmMatrix3x2 world; /**< Local-to-world matrix, valid after update. */
+    lmTransform local; /**< Transform relative to the parent. */
+    lm_uint64 entity; /**< ID of the entity. */
+    lm_uint64 parent; /**< ID of the parent entity or LM_TRANSFORM_ROOT. */
+    lm_uint32 parent_index; /**< Index of the parent node or LM_TRANSFORM_NO_INDEX. */
+    lm_uint32 depth; /**< Number of ancestors. */
+    bool dirty; /**< Local transform changed since the last update. */
+    bool recomputed; /**< World matrix was recomputed by the latest update, propagates to children. */
+    bool changed; /**< World matrix was recomputed this frame, cleared by lmTransformHierarchy_begin_frame. */
+} lmTransformNode;
+
+/**
+ * @brief Transform hierarchy.
+ * 
+ * Nodes are stored contiguously with every parent before its children, and
+ * sorted by depth whenever the structure changes. So propagating world
+ * matrices is a single forward pass where each node reads an already
+ * updated parent. Nodes are only recomputed if they or one of their
+ * ancestors changed, and the pass is skipped entirely if nothing did.
+ */
+typedef struct {
+    lmVec *nodes; /**< Nodes in update order. */
+    lmIntMap *indices; /**< Node indices by entity ID. */
+    size_t dirty_count; /**< Number of nodes marked dirty since the last update. */
+    bool needs_rebuild; /**< Order has to be rebuilt before the next update. */
+    bool has_changed; /**< Some node has its changed flag set. */
+} lmTransformHierarchy;
+
+/**
+ * @brief Create new transform hierarchy.
+ * 
+ * @return lmTransformHierarchy *
+ */
+lmTransformHierarchy *lmTransformHierarchy_new();
+
+/**
+ * @brief Free transform hierarchy.
+ * 
+ * @param hierarchy Transform hierarchy to free
+ */
+void lmTransformHierarchy_free(lmTransformHierarchy *hierarchy);
+
+/**
+ * @brief Add entity to the hierarchy. Returns `false` if the entity is
+ *        already in it or the parent isn't.
+ * 
+ * @param hierarchy Transform hierarchy
+ * @param entity Entity ID
+ * @param parent Parent entity ID or LM_TRANSFORM_ROOT
+ * @param local Transform relative to the parent
+ * @return bool
+ */
+bool lmTransformHierarchy_add(
+    lmTransformHierarchy *hierarchy,
+    lm_uint64 entity,
+    lm_uint64 parent,
+    lmTransform local
+);
+
+/**
+ * @brief Remove entity from the hierarchy. Its children become roots.
+ * 
+ * @param hierarchy Transform hierarchy
+ * @param entity Entity ID
+ * @return bool
+ */
+bool lmTransformHierarchy_remove(lmTransformHierarchy *hierarchy, lm_uint64 entity);
+
+/**
+ * @brief Change parent of an entity. Returns `false` if either entity isn't
+ *        in the hierarchy or the parent is a descendant of the entity.
+ * 
+ * @param hierarchy Transform hierarchy
+ * @param entity Entity ID
+ * @param parent Parent entity ID or LM_TRANSFORM_ROOT
+ * @return bool
+ */
+bool lmTransformHierarchy_set_parent(
+    lmTransformHierarchy *hierarchy,
+    lm_uint64 entity,
+    lm_uint64 parent
+);
+
+/**
+ * @brief Set local transform of an entity and mark it dirty.
+ * 
+ * @param hierarchy Transform hierarchy
+ * @param entity Entity ID
+ * @param local Transform relative to the parent
+ * @return bool
+ */
+bool lmTransformHierarchy_set_local(
+    lmTransformHierarchy *hierarchy,
+    lm_uint64 entity,
+    lmTransform local
+);
+
+/**
+ * @brief Get node of an entity. Returns `NULL` if it's not in the hierarchy.
+ * 
+ * The pointer is invalidated by adding, removing and reparenting. Modify
+ * the local transform with lmTransformHierarchy_set_local instead.
+ * 
+ * @param hierarchy Transform hierarchy
+ * @param entity Entity ID
+ * @return lmTransformNode *
+ */
+lmTransformNode *lmTransformHierarchy_get(lmTransformHierarchy *hierarchy, lm_uint64 entity);
+
+/**
+ * @brief Get world matrix of an entity as of the last update. Returns
+ *        identity if it's not in the hierarchy.
+ * 
+ * @param hierarchy Transform hierarchy
+ * @param entity Entity ID
+ * @return lmMatrix3x2
+ */
+lmMatrix3x2 lmTransformHierarchy_get_world(lmTransformHierarchy *hierarchy, lm_uint64 entity);
+
+/**
+ * @brief Clear changed flags of every node.
+ * 
+ * Called by the game loop once per frame before the updates, so flags set
+ * by any tick of the frame are still there in on_render.
+ * 
+ * @param hierarchy Transform hierarchy
+ */
+void lmTransformHierarchy_begin_frame(lmTransformHierarchy *hierarchy);
+
+/**
+ * @brief Propagate world matrices of dirty subtrees.
+ * 
+ * @param hierarchy Transform hierarchy
+ */
+void lmTransformHierarchy_update(lmTransformHierarchy *hierarchy);
+
+
+#endif
@@ -0,0 +1,92 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_ARENA_H
+#define _LUMINA_ARENA_H
+
+#include "lumina/_lumina.h"
+
+
+/**
+ * @file core/arena.h
+ * 
+ * @brief Per-frame linear (bump) allocator.
+ */
+
+
+typedef struct _lmFrameArenaBlock _lmFrameArenaBlock;
+
+/**
+ * @brief One half of the double-buffered arena.
+ */
+typedef struct {
+    lm_uint8 *data; /**< Main buffer. */
+    size_t capacity; /**< Size of the main buffer in bytes. */
+    size_t offset; /**< Bytes used in the main buffer. */
+    size_t requested; /**< Bytes requested this frame, including overflow. */
+    _lmFrameArenaBlock *overflow; /**< Heap blocks allocated when the main buffer was full. */
+} lmFrameArenaBuffer;
+
+/**
+ * @brief Per-frame linear allocator.
+ * 
+ * Allocations are bumped from a buffer that is reset every frame, so there is
+ * nothing to free. The arena is double-buffered: memory allocated in a frame
+ * stays valid until the end of the next frame, so it can be used to pass data
+ * on to the next frame.
+ * 
+ * If a frame needs more than the capacity, the excess is served from the
+ * heap and the buffer grows to fit when it is reused, so steady-state frames
+ * never touch the heap.
+ */
+typedef struct {
+    lmFrameArenaBuffer buffers[2]; /**< Double-buffered halves. */
+    lm_uint8 index; /**< Index of the half allocated from this frame. */
+    size_t peak; /**< Highest bytes requested in a single frame. */
+} lmFrameArena;
+
+/**
+ * @brief Create new frame arena.
+ * 
+ * @param capacity Starting capacity of each half in bytes
+ * @return lmFrameArena *
+ */
+lmFrameArena *lmFrameArena_new(size_t capacity);
+
+/**
+ * @brief Free frame arena.
+ * 
+ * @param arena Arena to free
+ */
+void lmFrameArena_free(lmFrameArena *arena);
+
+/**
+ * @brief Start a new frame.
+ * 
+ * Memory allocated two frames ago is released, memory allocated last frame
+ * stays valid.
+ * 
+ * @param arena Arena
+ */
+void lmFrameArena_reset(lmFrameArena *arena);
+
+/**
+ * @brief Allocate memory that lives until the end of the next frame.
+ * 
+ * The memory is aligned for any type. Returns `NULL` if failed.
+ * 
+ * @param arena Arena
+ * @param size Size in bytes
+ * @return void *
+ */
+void *lmFrameArena_alloc(lmFrameArena *arena, size_t size);
+
+
+#endif
@@ -12,6 +12,7 @@
 #define _LUMINA_CLOCK_H
 
 #include "lumina/_lumina.h"
+#include "lumina/core/constants.h"
 
 
 /**
@@ -21,6 +22,15 @@
  */
 
 
+/**
+ * @brief Frame pacing strategy used when limiting the frame rate.
+ */
+typedef enum {
+    lmClockPacing_SLEEP, /**< Sleep the remaining frame time with millisecond precision. */
+    lmClockPacing_PRECISE /**< Sleep coarsely, then spin until the exact deadline. */
+} lmClockPacing;
+
+
 typedef struct {
     double frequency;
     double accumulated_fps;
@@ -33,13 +43,39 @@ typedef struct {
     lm_uint64 timer_end;
     lm_uint64 timer_full_end;
     lm_uint32 fps_counter;
+
+    lmClockPacing pacing; /**< Frame pacing strategy. */
+    lm_uint64 deadline; /**< Absolute performance counter value the current frame should end at. */
+
+    double frame_times[LM_FRAME_TIME_HISTORY]; /**< Ring buffer of last frame times in milliseconds. */
+    size_t frame_times_index; /**< Next write position in the ring buffer. */
+    size_t frame_times_count; /**< Number of valid entries in the ring buffer. */
+    double frame_time_p50; /**< Median frame time of recent frames in milliseconds. */
+    double frame_time_p95; /**< 95th percentile frame time of recent frames in milliseconds. */
+    double frame_time_p99; /**< 99th percentile frame time of recent frames in milliseconds. */
 } lmClock;
 
 lmClock *lmClock_new();
 
 void lmClock_free(lmClock *clock);
 
+/**
+ * @brief Advance the clock and wait until the next frame should start.
+ * 
+ * @param clock Clock
+ * @param target_fps Frame rate to limit to, 0 for no limit
+ */
 void lmClock_tick(lmClock *clock, double target_fps);
 
+/**
+ * @brief Get the frame time at the given percentile of recent frames.
+ * 
+ * Returns 0 if no frames were recorded yet.
+ * 
+ * @param clock Clock
+ * @param percentile Percentile in range [0, 100]
+ * @return double Frame time in milliseconds
+ */
+double lmClock_get_frame_time_percentile(lmClock *clock, double percentile);
 
 #endif
\ No newline at end of file
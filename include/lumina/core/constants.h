@@ -22,9 +22,41 @@
 // Used to calculate the average FPS of last N frames.
 #define LM_FPS_UPDATE_FREQUENCY 10
 
+// Number of last frame times kept to calculate frame time percentiles.
+#define LM_FRAME_TIME_HISTORY 128
 
-// Maximum number of components per entity that can be allocated.
+// Precise pacing spin-waits for the last N milliseconds instead of sleeping,
+// since SDL_Delay can oversleep by about a millisecond on most schedulers.
+#define LM_CLOCK_SPIN_THRESHOLD 2.0
+
+
+// Starting capacity of each half of the per-frame arena in bytes.
+#define LM_FRAME_ARENA_CAPACITY (256 * 1024)
+
+
+// Number of text lines in the debug statistics overlay.
+#define LM_OVERLAY_LINES 6
+
+
+// Number of jobs that can wait in a thread pool before submitting runs
+// them on the calling thread.
+#define LM_THREAD_POOL_QUEUE_SIZE 1024
+
+// Bytes of decoded resources uploaded to the renderer per frame when
+// loading asynchronously. At least one resource is uploaded every frame.
+#define LM_RESOURCE_UPLOAD_BUDGET (4 * 1024 * 1024)
+
+// Milliseconds between modification time checks of watched files on
+// platforms without inotify.
+#define LM_FILE_WATCHER_POLL_INTERVAL 500
+
+
+// Maximum number of components a system can require.
 #define LM_MAX_COMPONENTS 64
 
+// Number of component IDs stored inline in entities and systems before
+// spilling to the heap. Keeps lmEntity at 64 bytes.
+#define LM_INLINE_COMPONENTS 6
+
 
 #endif
\ No newline at end of file
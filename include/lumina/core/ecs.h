@@ -13,7 +13,11 @@
 
 #include "lumina/_lumina.h"
 #include "lumina/core/constants.h"
+#include "lumina/core/string_id.h"
 #include "lumina/collections/hashmap.h"
+#include "lumina/collections/intmap.h"
+#include "lumina/collections/vec.h"
+#include "lumina/collections/small_vec.h"
 #include "lumina/math/vector.h"
 
 
@@ -39,13 +43,17 @@ typedef struct {
     size_t size;
 } lmComponents;
 
+/**
+ * @brief List of component IDs, short ones are stored inline.
+ */
+typedef LM_SMALL_VEC(lm_uint64, LM_INLINE_COMPONENTS) lmComponentIds;
+
 /**
  * @brief Internal representation of entities.
  */
 typedef struct {
     lm_uint64 id; /**< ID of the entity. */
-    lm_uint64 *comp_ids; /**< Array of IDs to this entity's components. */
-    size_t comps_size; /**< Size of the components array. */
+    lmComponentIds comp_ids; /**< IDs of this entity's components. */
 } lmEntity;
 
 // System function callback type
@@ -59,20 +67,31 @@ typedef void ( *lmSystem_function)(
  * @brief Internal representation of systems.
  */
 typedef struct {
-    const char *name; /**< Name of this system. */
+    const char *name; /**< Interned name of this system. */
+    lmStringId id; /**< ID of the name. */
     lmSystem_function function; /**< Function of this system. */
-    lm_uint64 *comp_ids; /**< Array of component IDs to run the system for. */
-    lm_uint64 comp_ids_size; /**< Size of the components array. */
+    lmComponentIds comp_ids; /**< IDs of the components to run the system for. */
     void *user_context;
 } lmSystem;
 
 
+/**
+ * @brief Densely packed components of one type.
+ */
+typedef struct {
+    lm_uint64 id; /**< ID of the component type. */
+    lmIntMap *index; /**< Entity ID -> index in the components array. */
+    lmVec *comps; /**< Array of components. */
+} lmComponentStore;
+
+
 /**
  * @brief ECS manager.
  */
 typedef struct {
-    lmHashMap *entities; /**< Hash map of entities. */
-    lmHashMap *components; /**< Hash map of components. */
+    lmVec *entities; /**< Array of entities. */
+    lmIntMap *entity_index; /**< Entity ID -> index in the entities array. */
+    lmIntMap *components; /**< Component ID -> component store. */
     lmHashMap *systems; /**< Hash map of systems. */
 } lmECS;
 
@@ -108,7 +127,23 @@ void lmECS_add_system(
     void *user_context
 );
 
+/**
+ * @brief Run system for every entity that has its components.
+ * 
+ * Hashes the name on every call, prefer lmECS_run_system_by_id with LM_SID.
+ * 
+ * @param ecs ECS
+ * @param system_name Name of the system
+ */
 void lmECS_run_system(lmECS *ecs, const char *system_name);
 
+/**
+ * @brief Run system by the string ID of its name.
+ * 
+ * @param ecs ECS
+ * @param system_id String ID of the system name
+ */
+void lmECS_run_system_by_id(lmECS *ecs, lmStringId system_id);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_FILE_WATCHER_H
+#define _LUMINA_FILE_WATCHER_H
+
+#include "lumina/_lumina.h"
+#include "lumina/collections/hashmap.h"
+#include "lumina/collections/vec.h"
+
+
+/**
+ * @file core/file_watcher.h
+ * 
+ * @brief Detects changes to files on disk.
+ */
+
+
+/**
+ * @brief Watched file.
+ */
+typedef struct {
+    char *filepath; /**< Path as it was added. */
+    lm_int64 mtime; /**< Last modification time, for polling. */
+    lm_int64 size; /**< Last size in bytes, for polling. */
+    bool polled; /**< Checked by polling, no inotify watch covers it. */
+} lmWatchedFile;
+
+/**
+ * @brief Watched directory.
+ */
+typedef struct {
+    int wd; /**< inotify watch descriptor. */
+    char *path; /**< Directory path, empty for the working directory. */
+} lmWatchedDirectory;
+
+/**
+ * @brief File watcher.
+ * 
+ * On Linux the directories of watched files are watched with inotify,
+ * so polling it is only a non-blocking read. Elsewhere, and for files
+ * whose directory couldn't be watched, modification times are checked
+ * every LM_FILE_WATCHER_POLL_INTERVAL milliseconds.
+ */
+typedef struct {
+    lmHashMap *files; /**< Watched files by path. */
+    lmVec *directories; /**< Watched directories, only used with inotify. */
+    int inotify_fd; /**< inotify instance, -1 when polling. */
+    size_t polled_count; /**< Number of files checked by polling. */
+    lm_uint64 last_poll; /**< Ticks of the last modification time check. */
+} lmFileWatcher;
+
+/**
+ * @brief Create a new file watcher.
+ * 
+ * @return lmFileWatcher *
+ */
+lmFileWatcher *lmFileWatcher_new();
+
+/**
+ * @brief Free file watcher.
+ * 
+ * @param watcher File watcher to free
+ */
+void lmFileWatcher_free(lmFileWatcher *watcher);
+
+/**
+ * @brief Start watching file. Does nothing if it's already watched.
+ * 
+ * @param watcher File watcher
+ * @param filepath Path of the file
+ */
+void lmFileWatcher_add(lmFileWatcher *watcher, const char *filepath);
+
+/**
+ * @brief Collect files changed since the last poll.
+ * 
+ * Paths of changed files are pushed to changed as `const char *`, each
+ * once per poll. They are owned by the watcher.
+ * 
+ * @param watcher File watcher
+ * @param changed Vector of const char * to push paths to
+ * @return size_t Number of changed files
+ */
+size_t lmFileWatcher_poll(lmFileWatcher *watcher, lmVec *changed);
+
+
+#endif
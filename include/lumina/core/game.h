@@ -12,9 +12,14 @@
 #define _LUMINA_GAME_H
 
 #include "lumina/_lumina.h"
+#include "lumina/core/constants.h"
+#include "lumina/core/arena.h"
 #include "lumina/core/window.h"
 #include "lumina/core/clock.h"
 #include "lumina/core/ecs.h"
+#include "lumina/core/overlay.h"
+#include "lumina/core/thread_pool.h"
+#include "lumina/components/transform_hierarchy.h"
 #include "lumina/resource/resource_manager.h"
 
 
@@ -27,6 +32,9 @@
 
 typedef void ( *lmGameEvent)(struct lmGame *);
 
+// Snapshot callback type, copies render-relevant state into the buffer
+typedef void ( *lmGameSnapshotEvent)(struct lmGame *, void *snapshot);
+
 
 typedef struct {
     const char *window_title;
@@ -36,6 +44,21 @@ typedef struct {
     lmGameEvent on_update;
     lmGameEvent on_render;
     lm_uint16 target_fps;
+    lmClockPacing frame_pacing;
+    bool fixed_timestep;
+    lm_uint16 tick_rate;
+    lm_uint16 max_ticks_per_frame;
+    bool threaded_update;
+    lmGameSnapshotEvent on_snapshot;
+    size_t snapshot_size;
+    bool show_stats;
+    double stats_interval;
+    size_t frame_arena_capacity;
+    size_t worker_threads;
+    size_t upload_budget;
+    size_t texture_budget;
+    const char *asset_pack;
+    bool hot_reload;
 } lmGameDef;
 
 static const lmGameDef lmGameDef_default = {
@@ -45,7 +68,22 @@ static const lmGameDef lmGameDef_default = {
     .on_ready = NULL,
     .on_update = NULL,
     .on_render = NULL,
-    .target_fps = 60
+    .target_fps = 60,
+    .frame_pacing = lmClockPacing_SLEEP,
+    .fixed_timestep = false,
+    .tick_rate = 60,
+    .max_ticks_per_frame = 5,
+    .threaded_update = false,
+    .on_snapshot = NULL,
+    .snapshot_size = 0,
+    .show_stats = true,
+    .stats_interval = 0.25,
+    .frame_arena_capacity = LM_FRAME_ARENA_CAPACITY,
+    .worker_threads = 0,
+    .upload_budget = LM_RESOURCE_UPLOAD_BUDGET,
+    .texture_budget = 0,
+    .asset_pack = "assets.lmpack",
+    .hot_reload = false
 };
 
 
@@ -58,7 +96,38 @@ struct lmGame{
     lm_uint16 target_fps;
     lmClock *clock;
     lmResourceManager *resource_manager;
+    lmThreadPool *thread_pool; /**< Workers for background jobs such as async resource loading. */
     lmECS *ecs;
+    lmTransformHierarchy *transforms; /**< Entity transform hierarchy, world matrices are updated after each on_update. */
+    lmOverlay *overlay; /**< Debug statistics overlay, NULL if disabled. */
+    lmFrameArena *frame_arena; /**< Per-frame arena of the main thread, use in on_render. */
+    lmFrameArena *update_arena; /**< Per-frame arena of the simulation, use in on_update. Same as frame_arena unless threaded. */
+
+    bool fixed_timestep; /**< Run on_update at a fixed rate independent of the frame rate. */
+    lm_uint16 max_ticks_per_frame; /**< Maximum number of on_update calls to catch up in one frame. */
+    double fixed_dt; /**< Simulation time step in seconds when using fixed timestep. */
+    double accumulator; /**< Unsimulated time carried over to the next frame in seconds. */
+    double alpha; /**< Interpolation factor between the previous (0) and current (1) simulation state, for on_render. */
+    double update_dt; /**< Time step of the current on_update call in seconds. */
+
+    /*
+        Pipelined update: on_update and on_snapshot of the next frame run on
+        a simulation thread while the main thread renders the current frame.
+        on_render must only read from game->snapshot in this mode.
+    */
+    bool threaded_update; /**< Run the simulation on a separate thread. */
+    lmGameSnapshotEvent on_snapshot; /**< Called after each update to fill the snapshot being written. */
+    size_t snapshot_size; /**< Size of a snapshot buffer in bytes. */
+    void *snapshots[2]; /**< Double-buffered snapshots. */
+    lm_uint8 snapshot_index; /**< Index of the snapshot the renderer reads from. */
+    void *snapshot; /**< Snapshot to render from, valid during on_render. */
+    size_t rendered_entities; /**< Entity count at the time the snapshot was taken. */
+    SDL_Thread *sim_thread;
+    SDL_sem *sim_start;
+    SDL_sem *sim_done;
+    bool sim_quit;
+    double sim_frame_dt;
+    double sim_alpha;
 };
 
 typedef struct lmGame lmGame;
@@ -22,7 +22,29 @@
 
 
 /**
- * @brief Get memory usage of the current process in bytes.
+ * @brief Memory statistics of the current process.
+ * 
+ * Fields that can't be queried on the current platform are 0.
+ */
+typedef struct {
+    size_t rss; /**< Resident set size (physical memory in use) in bytes. */
+    size_t peak_rss; /**< Highest resident set size reached in bytes. */
+    size_t virtual_size; /**< Virtual memory size in bytes. */
+    size_t heap_bytes; /**< Bytes currently allocated through lm_malloc, 0 if not tracked. */
+} lmMemoryStats;
+
+/**
+ * @brief Get memory statistics of the current process.
+ * 
+ * This is cheap enough to call every frame, on Linux it is a single `pread`
+ * on a file descriptor kept open and one `getrusage` call.
+ * 
+ * @return lmMemoryStats
+ */
+lmMemoryStats lm_get_memory_stats();
+
+/**
+ * @brief Get memory usage (resident set size) of the current process in bytes.
  * 
  * Returns 0 if failed.
  * 
@@ -31,5 +53,4 @@
 size_t lm_get_current_memory_usage();
 
 
-
 #endif
\ No newline at end of file
@@ -0,0 +1,141 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_MEMORY_H
+#define _LUMINA_MEMORY_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "lumina/core/types.h"
+
+
+/**
+ * @file core/memory.h
+ * 
+ * @brief Pluggable allocator and per-subsystem memory tracking.
+ * 
+ * Every allocation the engine makes goes through lm_malloc, lm_realloc and
+ * lm_free. Unless LM_NO_MEMORY_TRACKING is defined, each allocation carries a
+ * small header with its size and tag so byte counts, allocation counts and
+ * high-water marks can be queried per subsystem at runtime.
+ */
+
+
+/**
+ * @brief Subsystem an allocation belongs to.
+ */
+typedef enum {
+    lmMemoryTag_GENERAL, /**< Untagged allocations. */
+    lmMemoryTag_CORE, /**< Game, window, clock and overlay. */
+    lmMemoryTag_COLLECTIONS, /**< Arrays and hash maps. */
+    lmMemoryTag_ECS, /**< Entities, components and systems. */
+    lmMemoryTag_RESOURCE, /**< Resource manager, fonts and textures. */
+    lmMemoryTag_GRAPHICS, /**< Drawing buffers. */
+    lmMemoryTag_USER, /**< Allocations made by the game. */
+    lmMemoryTag_COUNT /**< Number of tags, not a valid tag. */
+} lmMemoryTag;
+
+/**
+ * @brief Get the memory tag as string.
+ * 
+ * @param tag Memory tag
+ * @return const char *
+ */
+const char *lmMemoryTag_as_string(lmMemoryTag tag);
+
+
+/**
+ * @brief Allocator callbacks.
+ * 
+ * The callbacks follow the semantics of malloc, realloc and free.
+ */
+typedef struct {
+    void *(*alloc)(size_t size, void *user_data);
+    void *(*realloc)(void *ptr, size_t size, void *user_data);
+    void (*free)(void *ptr, void *user_data);
+    void *user_data;
+} lmAllocator;
+
+/**
+ * @brief Set the allocator used by the engine.
+ * 
+ * This must be called before anything is allocated by the engine, memory
+ * allocated with one allocator can't be freed by another.
+ * 
+ * @param allocator Allocator callbacks
+ */
+void lm_set_allocator(lmAllocator allocator);
+
+/**
+ * @brief Get the allocator used by the engine.
+ * 
+ * @return lmAllocator
+ */
+lmAllocator lm_get_allocator();
+
+/**
+ * @brief Allocate memory. Returns `NULL` if failed.
+ * 
+ * @param size Size in bytes
+ * @param tag Subsystem tag
+ * @return void *
+ */
+void *lm_malloc(size_t size, lmMemoryTag tag);
+
+/**
+ * @brief Reallocate memory. Returns `NULL` if failed.
+ * 
+ * The allocation keeps the tag it was first allocated with, unless `ptr` is
+ * `NULL` in which case this is the same as lm_malloc.
+ * 
+ * @param ptr Memory to reallocate
+ * @param size New size in bytes
+ * @param tag Subsystem tag
+ * @return void *
+ */
+void *lm_realloc(void *ptr, size_t size, lmMemoryTag tag);
+
+/**
+ * @brief Free memory allocated with lm_malloc or lm_realloc.
+ * 
+ * @param ptr Memory to free, can be `NULL`
+ */
+void lm_free(void *ptr);
+
+
+/**
+ * @brief Memory statistics of a subsystem tag.
+ */
+typedef struct {
+    size_t bytes; /**< Bytes currently allocated. */
+    size_t peak_bytes; /**< Highest value bytes ever reached. */
+    size_t allocations; /**< Number of live allocations. */
+    size_t total_allocations; /**< Number of allocations made so far. */
+} lmMemoryTagStats;
+
+/**
+ * @brief Get memory statistics of a subsystem tag.
+ * 
+ * All fields are 0 if LM_NO_MEMORY_TRACKING is defined.
+ * 
+ * @param tag Memory tag
+ * @return lmMemoryTagStats
+ */
+lmMemoryTagStats lm_get_memory_tag_stats(lmMemoryTag tag);
+
+/**
+ * @brief Get the bytes currently allocated by all subsystems.
+ * 
+ * @return size_t
+ */
+size_t lm_get_tracked_heap_bytes();
+
+
+#endif
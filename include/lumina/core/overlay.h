@@ -0,0 +1,79 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_OVERLAY_H
+#define _LUMINA_OVERLAY_H
+
+#include "lumina/_lumina.h"
+#include "lumina/core/constants.h"
+#include "lumina/resource/font.h"
+
+
+/**
+ * @file core/overlay.h
+ * 
+ * @brief Debug statistics overlay.
+ */
+
+
+/**
+ * @brief Line of text rasterized into a texture.
+ */
+typedef struct {
+    SDL_Texture *texture; /**< Cached texture of the text, NULL if empty. */
+    int width; /**< Width of the texture in pixels. */
+    int height; /**< Height of the texture in pixels. */
+} lmOverlayLine;
+
+/**
+ * @brief Debug statistics overlay.
+ * 
+ * Static lines are rasterized once, dynamic lines are rasterized again only
+ * every refresh interval. Memory usage is sampled on a background thread.
+ */
+typedef struct {
+    lmFont *font; /**< Font the lines are rendered with. */
+    double interval; /**< Refresh interval of dynamic lines in seconds. */
+    double last_refresh; /**< Clock time of the last refresh. */
+    lmOverlayLine lines[LM_OVERLAY_LINES]; /**< Cached lines. */
+
+    size_t memory_used; /**< Last sampled memory usage in bytes. */
+    SDL_SpinLock memory_lock; /**< Lock guarding memory_used. */
+    SDL_Thread *memory_thread; /**< Memory sampling thread. */
+    SDL_sem *memory_quit; /**< Posted to stop the sampling thread. */
+} lmOverlay;
+
+/**
+ * @brief Create new overlay.
+ * 
+ * @param game Game instance
+ * @param font Font to render the text with
+ * @param interval Refresh interval of dynamic lines in seconds
+ * @return lmOverlay *
+ */
+lmOverlay *lmOverlay_new(struct lmGame *game, lmFont *font, double interval);
+
+/**
+ * @brief Free overlay.
+ * 
+ * @param overlay Overlay to free
+ */
+void lmOverlay_free(lmOverlay *overlay);
+
+/**
+ * @brief Render overlay, refreshing dynamic lines if the interval has passed.
+ * 
+ * @param overlay Overlay
+ * @param game Game instance
+ */
+void lmOverlay_render(lmOverlay *overlay, struct lmGame *game);
+
+
+#endif
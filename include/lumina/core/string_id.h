@@ -0,0 +1,101 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_STRING_ID_H
+#define _LUMINA_STRING_ID_H
+
+#include "lumina/_lumina.h"
+#include "lumina/math/hash.h"
+
+
+/**
+ * @file core/string_id.h
+ * 
+ * @brief Interned string IDs.
+ */
+
+
+/**
+ * @brief 64-bit ID of a string, the FNV-1a hash of it.
+ * 
+ * Resources and systems are keyed on these so lookups compare integers
+ * instead of hashing and comparing strings every call.
+ */
+typedef lm_uint64 lmStringId;
+
+/*
+    FNV-1a unrolled over the first 64 characters, characters past the end of
+    the literal are steps that don't change the hash. Indexing a literal
+    isn't an integer constant expression, so this can't be a case label.
+    GCC still folds it to a constant, which also makes it work in static
+    initializers.
+*/
+#define _LM_SID_1(s, i, h) (                                                 \
+    ((h) ^ (lm_uint64)(s)[(i) < sizeof(s) - 1 ? (i) : 0] * ((i) < sizeof(s) - 1)) \
+    * ((i) < sizeof(s) - 1 ? LM_FNV_PRIME : 1)                                \
+)
+#define _LM_SID_4(s, i, h) _LM_SID_1(s, (i) + 3, _LM_SID_1(s, (i) + 2, _LM_SID_1(s, (i) + 1, _LM_SID_1(s, i, h))))
+#define _LM_SID_16(s, i, h) _LM_SID_4(s, (i) + 12, _LM_SID_4(s, (i) + 8, _LM_SID_4(s, (i) + 4, _LM_SID_4(s, i, h))))
+#define _LM_SID_64(s, i, h) _LM_SID_16(s, (i) + 48, _LM_SID_16(s, (i) + 32, _LM_SID_16(s, (i) + 16, _LM_SID_16(s, i, h))))
+
+/**
+ * @brief String ID of a string literal, folded at compile time.
+ * 
+ * Only takes literals of up to 64 characters, anything else fails to
+ * compile. Use lm_string_id for other strings. Not usable as a switch
+ * case label, compare IDs with if instead.
+ */
+#define LM_SID(literal) (                                                      \
+    (lmStringId)_LM_SID_64(("" literal ""), 0, LM_FNV_BASIS) + 0 * sizeof(struct { \
+        _Static_assert(sizeof(literal) <= 65, "LM_SID literal is longer than 64 characters."); \
+        int _unused;                                                           \
+    })                                                                         \
+)
+
+/**
+ * @brief Get ID of a string without interning it.
+ * 
+ * @param str Zero-terminated string
+ * @return lmStringId
+ */
+static inline lmStringId lm_string_id(const char *str) {
+    return lm_fnv1a(str);
+}
+
+/**
+ * @brief Get ID of a string and remember the string for it.
+ * 
+ * Raises an error if a different string was interned with the same ID.
+ * Thread-safe.
+ * 
+ * @param str Zero-terminated string
+ * @return lmStringId
+ */
+lmStringId lm_intern_string(const char *str);
+
+/**
+ * @brief Get the interned string of an ID, `NULL` if it was never interned.
+ * 
+ * The string stays valid until lm_string_ids_free.
+ * 
+ * @param id String ID
+ * @return const char *
+ */
+const char *lm_string_id_lookup(lmStringId id);
+
+/**
+ * @brief Free all interned strings.
+ * 
+ * Called when the game is freed.
+ */
+void lm_string_ids_free();
+
+
+#endif
@@ -0,0 +1,80 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_THREAD_POOL_H
+#define _LUMINA_THREAD_POOL_H
+
+#include "lumina/_lumina.h"
+#include "lumina/collections/queue.h"
+
+
+/**
+ * @file core/thread_pool.h
+ * 
+ * @brief Pool of worker threads running background jobs.
+ */
+
+
+// Job function callback type
+typedef void ( *lmJobFunction)(void *user_data);
+
+/**
+ * @brief Job submitted to a thread pool.
+ */
+typedef struct {
+    lmJobFunction function; /**< Function to run. */
+    void *user_data; /**< Data passed to the function. */
+} lmJob;
+
+/**
+ * @brief Pool of worker threads.
+ * 
+ * Jobs go through a lock-free MPMC queue and a semaphore wakes up one
+ * sleeping worker per job. With no worker threads (on web) jobs run right
+ * away on the submitting thread.
+ */
+typedef struct {
+    SDL_Thread **threads; /**< Worker threads. */
+    size_t thread_count; /**< Number of worker threads. */
+    lmMPMCQueue *jobs; /**< Queued jobs. */
+    SDL_sem *job_signal; /**< Counts queued jobs, workers sleep on it. */
+    bool quit; /**< Set to stop the workers. */
+} lmThreadPool;
+
+/**
+ * @brief Create new thread pool.
+ * 
+ * @param thread_count Number of worker threads, 0 for one less than the number of CPU cores
+ * @return lmThreadPool *
+ */
+lmThreadPool *lmThreadPool_new(size_t thread_count);
+
+/**
+ * @brief Free thread pool.
+ * 
+ * Waits for the queued jobs to finish first.
+ * 
+ * @param pool Thread pool to free
+ */
+void lmThreadPool_free(lmThreadPool *pool);
+
+/**
+ * @brief Queue job to run on a worker thread.
+ * 
+ * If the queue is full the job runs right away on the calling thread.
+ * 
+ * @param pool Thread pool
+ * @param function Job function
+ * @param user_data Data passed to the function
+ */
+void lmThreadPool_submit(lmThreadPool *pool, lmJobFunction function, void *user_data);
+
+
+#endif
@@ -41,5 +41,14 @@ typedef struct {
  */
 lmColor lmColor_from_hsv(lmColor hsv_color);
 
+/**
+ * @brief Convert many colors from HSV to RGB.
+ * 
+ * @param hsv_colors Colors in HSV space
+ * @param out Array to store the converted colors, can be the same as hsv_colors
+ * @param n Number of colors
+ */
+void lmColor_from_hsv_batch(const lmColor *hsv_colors, lmColor *out, size_t n);
+
 
 #endif
\ No newline at end of file
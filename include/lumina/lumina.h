@@ -22,7 +22,12 @@
 #include "lumina/_lumina.h"
 
 #include "lumina/collections/array.h"
+#include "lumina/collections/vec.h"
+#include "lumina/collections/small_vec.h"
 #include "lumina/collections/hashmap.h"
+#include "lumina/collections/intmap.h"
+#include "lumina/collections/concurrent_hashmap.h"
+#include "lumina/collections/queue.h"
 
 #include "lumina/core/constants.h"
 #include "lumina/core/types.h"
@@ -31,8 +36,15 @@
 #include "lumina/core/clock.h"
 #include "lumina/core/ecs.h"
 #include "lumina/core/hwinfo.h"
+#include "lumina/core/memory.h"
+#include "lumina/core/arena.h"
+#include "lumina/core/overlay.h"
+#include "lumina/core/thread_pool.h"
+#include "lumina/core/file_watcher.h"
+#include "lumina/core/string_id.h"
 
 #include "lumina/components/transform.h"
+#include "lumina/components/transform_hierarchy.h"
 #include "lumina/components/sprite.h"
 
 #include "lumina/graphics/color.h"
@@ -40,11 +52,16 @@
 
 #include "lumina/resource/resource_manager.h"
 #include "lumina/resource/texture.h"
+#include "lumina/resource/font.h"
+#include "lumina/resource/pack.h"
 
 #include "lumina/math/math.h"
 #include "lumina/math/constants.h"
+#include "lumina/math/fastmath.h"
 #include "lumina/math/hash.h"
+#include "lumina/math/matrix.h"
 #include "lumina/math/random.h"
 #include "lumina/math/vector.h"
+#include "lumina/math/vector_batch.h"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,207 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_FASTMATH_H
+#define _LUMINA_FASTMATH_H
+
+#include "lumina/_lumina.h"
+#include "lumina/math/vector.h"
+
+#if defined(__SSE__)
+    #include <xmmintrin.h>
+#endif
+
+
+/**
+ * @file math/fastmath.h
+ * 
+ * @brief Approximate math functions for hot paths.
+ * 
+ * These are inlined and never call into libm. Use the regular functions
+ * where results have to match the C library exactly.
+ */
+
+
+/**
+ * @brief Sine and cosine of an angle.
+ * 
+ * For |x| <= 8192 the angle is reduced to [-pi/4, pi/4] and both are
+ * evaluated with minimax polynomials, absolute error is below 1e-7.
+ * Larger angles, infinities and NaN go through sinf and cosf, so the
+ * result is always as accurate as libm's, just not fast out of range.
+ * 
+ * @param x Angle in radians
+ * @param s Pointer to store the sine
+ * @param c Pointer to store the cosine
+ */
+static inline void lm_fast_sincos(float x, float *s, float *c) {
+    // The reduction below loses precision past this, and the quarter turn
+    // count overflows for |x| > ~3.4e9. Also catches NaN.
+    if (!(fabsf(x) <= 8192.0f)) {
+        *s = sinf(x);
+        *c = cosf(x);
+        return;
+    }
+
+    // Round to the nearest quarter turn
+    float kf = x * 0.63661977236758134f;
+    lm_int32 k = (lm_int32)(kf + (kf >= 0.0f ? 0.5f : -0.5f));
+    kf = (float)k;
+
+    // pi/2 split in three so the first products are exact (Cody-Waite)
+    float r = x - kf * 1.5703125f;
+    r = r - kf * 4.837512969970703125e-4f;
+    r = r - kf * 7.54978995489188216e-8f;
+
+    float z = r * r;
+    float sr = r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+    float cr = 1.0f - 0.5f * z + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+
+    lm_uint32 q = (lm_uint32)k;
+    float ss = (q & 1) ? cr : sr;
+    float cc = (q & 1) ? sr : cr;
+    *s = (q & 2) ? -ss : ss;
+    *c = ((q + 1) & 2) ? -cc : cc;
+}
+
+/**
+ * @brief Sine of an angle, see lm_fast_sincos for accuracy.
+ * 
+ * @param x Angle in radians
+ * @return float
+ */
+static inline float lm_fast_sin(float x) {
+    float s, c;
+    lm_fast_sincos(x, &s, &c);
+    return s;
+}
+
+/**
+ * @brief Cosine of an angle, see lm_fast_sincos for accuracy.
+ * 
+ * @param x Angle in radians
+ * @return float
+ */
+static inline float lm_fast_cos(float x) {
+    float s, c;
+    lm_fast_sincos(x, &s, &c);
+    return c;
+}
+
+/**
+ * @brief Reciprocal square root, relative error is below 5e-6.
+ * 
+ * Uses the rsqrtss estimate when SSE is available and the integer
+ * estimate otherwise, refined with Newton-Raphson steps.
+ * 
+ * @param x Positive value
+ * @return float
+ */
+static inline float lm_fast_rsqrt(float x) {
+    #if defined(__SSE__)
+
+        float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+        return y * (1.5f - 0.5f * x * y * y);
+
+    #else
+
+        lm_uint32 i;
+        float y;
+        memcpy(&i, &x, 4);
+        i = 0x5f375a86 - (i >> 1);
+        memcpy(&y, &i, 4);
+
+        y = y * (1.5f - 0.5f * x * y * y);
+        return y * (1.5f - 0.5f * x * y * y);
+
+    #endif
+}
+
+/**
+ * @brief Normalize vector with lm_fast_rsqrt. Zero vector stays zero.
+ * 
+ * @param v Vector to normalize
+ * @return lmVector2
+ */
+static inline lmVector2 lmVector2_fast_normalize(lmVector2 v) {
+    float len2 = lmVector2_len2(v);
+    if (len2 == 0.0f) return v;
+    return lmVector2_mul(v, lm_fast_rsqrt(len2));
+}
+
+/**
+ * @brief Rotate vector using lm_fast_sincos.
+ * 
+ * @param v Vector to rotate
+ * @param a Angle in radians
+ * @return lmVector2
+ */
+static inline lmVector2 lmVector2_fast_rotate(lmVector2 v, float a) {
+    float s, c;
+    lm_fast_sincos(a, &s, &c);
+    return LM_VEC2(c * v.x - s * v.y, s * v.x + c * v.y);
+}
+
+
+/**
+ * @brief Precomputed rotations for evenly spaced angles.
+ * 
+ * For things that only ever face a fixed number of directions, rotating
+ * is then a table lookup instead of evaluating sine and cosine.
+ */
+typedef struct {
+    size_t steps; /**< Number of angles in a full turn. */
+    float steps_per_radian; /**< steps / tau, converts angles to indices. */
+    lmVector2 *rotations; /**< Cosine and sine of each angle as x and y. */
+} lmRotationTable;
+
+/**
+ * @brief Create new rotation table.
+ * 
+ * @param steps Number of angles in a full turn
+ * @return lmRotationTable *
+ */
+lmRotationTable *lmRotationTable_new(size_t steps);
+
+/**
+ * @brief Free rotation table.
+ * 
+ * @param table Rotation table to free
+ */
+void lmRotationTable_free(lmRotationTable *table);
+
+/**
+ * @brief Get index of the closest angle in the table.
+ * 
+ * @param table Rotation table
+ * @param angle Angle in radians, can be negative or over a full turn
+ * @return size_t
+ */
+static inline size_t lmRotationTable_index(lmRotationTable *table, float angle) {
+    float f = angle * table->steps_per_radian;
+    lm_int64 i = (lm_int64)(f + (f >= 0.0f ? 0.5f : -0.5f)) % (lm_int64)table->steps;
+    return (size_t)(i < 0 ? i + (lm_int64)table->steps : i);
+}
+
+/**
+ * @brief Rotate vector by the angle at index.
+ * 
+ * @param table Rotation table
+ * @param v Vector to rotate
+ * @param index Angle index
+ * @return lmVector2
+ */
+static inline lmVector2 lmRotationTable_rotate(lmRotationTable *table, lmVector2 v, size_t index) {
+    lmVector2 r = table->rotations[index];
+    return LM_VEC2(r.x * v.x - r.y * v.y, r.y * v.x + r.x * v.y);
+}
+
+
+#endif
@@ -24,6 +24,9 @@
 /**
  * @brief Cantor pairing function for unsigned 64-bit integers.
  * 
+ * Only unique while x + y stays below 2^32, past that the result wraps
+ * around. Use lm_hash_combine to hash composite keys.
+ * 
  * @param x First number
  * @param y Second number
  * @return lm_uint64 
@@ -37,6 +40,27 @@ static inline lm_uint64 lm_u64cantor(lm_uint64 x, lm_uint64 y) {
 }
 
 
+/**
+ * @brief Mix the bits of an unsigned 64-bit integer.
+ * 
+ * Every input bit affects every output bit, so sequential or patterned keys
+ * like entity IDs spread evenly when the result is used for table indexing.
+ * This is the MurmurHash3 64-bit finalizer and it is a bijection.
+ * 
+ * @param x Number to mix
+ * @return lm_uint64 
+ */
+static inline lm_uint64 lm_u64mix(lm_uint64 x) {
+    // https://github.com/aappleby/smhasher/blob/master/src/MurmurHash3.cpp
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+
 #define LM_FNV_PRIME 1099511628211ULL
 #define LM_FNV_BASIS 14695981039346656037ULL
 
@@ -60,4 +84,146 @@ static inline lm_uint64 lm_fnv1a(const char *str) {
 }
 
 
+/**
+ * @brief Combine a hash with another value, for keys made of several fields.
+ * 
+ * Order matters, combining a then b differs from b then a.
+ * 
+ * @param seed Hash so far
+ * @param value Value to combine into it
+ * @return lm_uint64
+ */
+static inline lm_uint64 lm_hash_combine(lm_uint64 seed, lm_uint64 value) {
+    // The 0x9E37... constant is 2^64 / golden ratio, as in boost::hash_combine
+    return lm_u64mix(seed ^ (value + 0x9E3779B97F4A7C15ULL + (seed << 6) + (seed >> 2)));
+}
+
+
+/*
+    wyhash
+
+    Reads 8 or 16 bytes at a time and mixes with 64x64->128 bit multiplies,
+    several times faster than FNV-1a past a handful of bytes.
+    Results assume a little-endian platform, they are for in-memory tables
+    only and must not be stored. The pack format keeps using FNV-1a.
+    https://github.com/wangyi-fudan/wyhash
+*/
+
+#define _LM_WYP0 0x2D358DCCAA6C78A5ULL
+#define _LM_WYP1 0x8BB84B93962EACC9ULL
+#define _LM_WYP2 0x4B33A62ED433D4A3ULL
+#define _LM_WYP3 0x4D5A2DA51DE1AA47ULL
+
+static inline void _lm_wymum(lm_uint64 *a, lm_uint64 *b) {
+    #ifdef __SIZEOF_INT128__
+        __uint128_t r = (__uint128_t)*a * *b;
+        *a = (lm_uint64)r;
+        *b = (lm_uint64)(r >> 64);
+    #else
+        lm_uint64 ha = *a >> 32, hb = *b >> 32, la = (lm_uint32)*a, lb = (lm_uint32)*b;
+        lm_uint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        lm_uint64 t = rl + (rm0 << 32);
+        lm_uint64 c = t < rl;
+        lm_uint64 lo = t + (rm1 << 32);
+        c += lo < t;
+        *a = lo;
+        *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    #endif
+}
+
+static inline lm_uint64 _lm_wymix(lm_uint64 a, lm_uint64 b) {
+    _lm_wymum(&a, &b);
+    return a ^ b;
+}
+
+static inline lm_uint64 _lm_wyr8(const lm_uint8 *p) {
+    lm_uint64 v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline lm_uint64 _lm_wyr4(const lm_uint8 *p) {
+    lm_uint32 v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static inline lm_uint64 _lm_wyr3(const lm_uint8 *p, size_t k) {
+    return ((lm_uint64)p[0] << 16) | ((lm_uint64)p[k >> 1] << 8) | p[k - 1];
+}
+
+/**
+ * @brief Hash a byte buffer.
+ * 
+ * @param data Data to hash
+ * @param len Length of the data in bytes
+ * @param seed Seed, 0 if you don't need one
+ * @return lm_uint64
+ */
+static inline lm_uint64 lm_hash_bytes(const void *data, size_t len, lm_uint64 seed) {
+    const lm_uint8 *p = (const lm_uint8 *)data;
+    lm_uint64 a, b;
+
+    seed ^= _lm_wymix(seed ^ _LM_WYP0, _LM_WYP1);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (_lm_wyr4(p) << 32) | _lm_wyr4(p + ((len >> 3) << 2));
+            b = (_lm_wyr4(p + len - 4) << 32) | _lm_wyr4(p + len - 4 - ((len >> 3) << 2));
+        }
+        else if (len > 0) {
+            a = _lm_wyr3(p, len);
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
+    }
+    else {
+        size_t i = len;
+
+        if (i >= 48) {
+            lm_uint64 see1 = seed, see2 = seed;
+            do {
+                seed = _lm_wymix(_lm_wyr8(p) ^ _LM_WYP1, _lm_wyr8(p + 8) ^ seed);
+                see1 = _lm_wymix(_lm_wyr8(p + 16) ^ _LM_WYP2, _lm_wyr8(p + 24) ^ see1);
+                see2 = _lm_wymix(_lm_wyr8(p + 32) ^ _LM_WYP3, _lm_wyr8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i >= 48);
+            seed ^= see1 ^ see2;
+        }
+
+        while (i > 16) {
+            seed = _lm_wymix(_lm_wyr8(p) ^ _LM_WYP1, _lm_wyr8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+
+        // Last 16 bytes, may overlap the ones already read
+        a = _lm_wyr8(p + i - 16);
+        b = _lm_wyr8(p + i - 8);
+    }
+
+    a ^= _LM_WYP1;
+    b ^= seed;
+    _lm_wymum(&a, &b);
+
+    return _lm_wymix(a ^ _LM_WYP0 ^ len, b ^ _LM_WYP1);
+}
+
+/**
+ * @brief Hash a zero-terminated string.
+ * 
+ * Faster than lm_fnv1a for anything but very short strings. Use lm_fnv1a
+ * or lm_string_id where the hash has to match LM_SID or pack files.
+ * 
+ * @param str Zero-terminated string to hash
+ * @return lm_uint64
+ */
+static inline lm_uint64 lm_hash_string(const char *str) {
+    return lm_hash_bytes(str, strlen(str), 0);
+}
+
+
 #endif
\ No newline at end of file
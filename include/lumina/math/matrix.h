@@ -0,0 +1,175 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_MATRIX_H
+#define _LUMINA_MATRIX_H
+
+#include "lumina/_lumina.h"
+#include "lumina/math/vector.h"
+
+
+/**
+ * @file math/matrix.h
+ * 
+ * @brief 2D affine transform matrices.
+ */
+
+
+/**
+ * @brief 2D affine transform, a 3x3 matrix with the constant last row left out.
+ * 
+ * | a  c  tx |
+ * | b  d  ty |
+ * | 0  0  1  |
+ */
+typedef struct {
+    float a; /**< X axis, x component. */
+    float b; /**< X axis, y component. */
+    float c; /**< Y axis, x component. */
+    float d; /**< Y axis, y component. */
+    float tx; /**< Translation x. */
+    float ty; /**< Translation y. */
+} lmMatrix3x2;
+
+
+/**
+ * @brief Identity matrix.
+ */
+static const lmMatrix3x2 lmMatrix3x2_identity = {1.0, 0.0, 0.0, 1.0, 0.0, 0.0};
+
+
+/**
+ * @brief Build matrix that scales, then rotates, then translates.
+ * 
+ * @param position Translation
+ * @param rotation Rotation in radians
+ * @param scale Scale
+ * @return lmMatrix3x2
+ */
+static inline lmMatrix3x2 lmMatrix3x2_from_trs(lmVector2 position, float rotation, lmVector2 scale) {
+    float c = cosf(rotation);
+    float s = sinf(rotation);
+
+    return (lmMatrix3x2){
+        c * scale.x, s * scale.x,
+        -s * scale.y, c * scale.y,
+        position.x, position.y
+    };
+}
+
+/**
+ * @brief Multiply two matrices, the result applies b first and then a.
+ * 
+ * For hierarchies this is world = parent * local.
+ * 
+ * @param a Left-hand matrix
+ * @param b Right-hand matrix
+ * @return lmMatrix3x2
+ */
+static inline lmMatrix3x2 lmMatrix3x2_mul(lmMatrix3x2 a, lmMatrix3x2 b) {
+    return (lmMatrix3x2){
+        a.a * b.a + a.c * b.b,
+        a.b * b.a + a.d * b.b,
+        a.a * b.c + a.c * b.d,
+        a.b * b.c + a.d * b.d,
+        a.a * b.tx + a.c * b.ty + a.tx,
+        a.b * b.tx + a.d * b.ty + a.ty
+    };
+}
+
+/**
+ * @brief Transform a point, translation applies.
+ * 
+ * @param m Matrix
+ * @param p Point
+ * @return lmVector2
+ */
+static inline lmVector2 lmMatrix3x2_transform_point(lmMatrix3x2 m, lmVector2 p) {
+    return LM_VEC2(m.a * p.x + m.c * p.y + m.tx, m.b * p.x + m.d * p.y + m.ty);
+}
+
+/**
+ * @brief Transform a direction, translation doesn't apply.
+ * 
+ * @param m Matrix
+ * @param v Vector
+ * @return lmVector2
+ */
+static inline lmVector2 lmMatrix3x2_transform_vector(lmMatrix3x2 m, lmVector2 v) {
+    return LM_VEC2(m.a * v.x + m.c * v.y, m.b * v.x + m.d * v.y);
+}
+
+/**
+ * @brief Calculate determinant.
+ * 
+ * @param m Matrix
+ * @return float
+ */
+static inline float lmMatrix3x2_determinant(lmMatrix3x2 m) {
+    return m.a * m.d - m.b * m.c;
+}
+
+/**
+ * @brief Invert matrix. Returns identity if it isn't invertible (zero scale).
+ * 
+ * @param m Matrix
+ * @return lmMatrix3x2
+ */
+static inline lmMatrix3x2 lmMatrix3x2_inverse(lmMatrix3x2 m) {
+    float det = lmMatrix3x2_determinant(m);
+    if (det == 0.0f) return lmMatrix3x2_identity;
+
+    float inv = 1.0f / det;
+    float a = m.d * inv;
+    float b = -m.b * inv;
+    float c = -m.c * inv;
+    float d = m.a * inv;
+
+    return (lmMatrix3x2){
+        a, b, c, d,
+        -(a * m.tx + c * m.ty),
+        -(b * m.tx + d * m.ty)
+    };
+}
+
+/**
+ * @brief Get translation of a matrix.
+ * 
+ * @param m Matrix
+ * @return lmVector2
+ */
+static inline lmVector2 lmMatrix3x2_get_position(lmMatrix3x2 m) {
+    return LM_VEC2(m.tx, m.ty);
+}
+
+/**
+ * @brief Get rotation of a matrix in radians.
+ * 
+ * @param m Matrix
+ * @return float
+ */
+static inline float lmMatrix3x2_get_rotation(lmMatrix3x2 m) {
+    return atan2f(m.b, m.a);
+}
+
+/**
+ * @brief Get scale of a matrix, assuming it has no shear.
+ * 
+ * @param m Matrix
+ * @return lmVector2
+ */
+static inline lmVector2 lmMatrix3x2_get_scale(lmMatrix3x2 m) {
+    float sx = sqrtf(m.a * m.a + m.b * m.b);
+    float sy = lmMatrix3x2_determinant(m) / sx;
+    return LM_VEC2(sx, sy);
+}
+
+
+#endif
@@ -0,0 +1,179 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_VECTOR_BATCH_H
+#define _LUMINA_VECTOR_BATCH_H
+
+#include "lumina/_lumina.h"
+#include "lumina/math/vector.h"
+
+
+/**
+ * @file math/vector_batch.h
+ * 
+ * @brief 2D vector math over many vectors at once.
+ * 
+ * Vectors are stored as structure-of-arrays so the kernels can process 4
+ * (SSE2, NEON) or 8 (AVX2) of them per instruction. The instruction set is
+ * picked at runtime on first use, with a scalar fallback everywhere else.
+ * 
+ * Output arrays may be the same as input arrays, but must not partially
+ * overlap them.
+ */
+
+
+/**
+ * @brief Array of 2D vectors in structure-of-arrays layout.
+ */
+typedef struct {
+    float *x; /**< X components. */
+    float *y; /**< Y components. */
+} lmVector2SoA;
+
+
+/**
+ * @brief Get name of the instruction set the kernels use.
+ * 
+ * @return const char * "avx2", "sse2", "neon" or "scalar"
+ */
+const char *lm_vector_batch_isa();
+
+/**
+ * @brief out = a + b
+ * 
+ * @param out Output vectors
+ * @param a Left-hand vectors
+ * @param b Right-hand vectors
+ * @param n Number of vectors
+ */
+void lmVector2SoA_add(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, size_t n);
+
+/**
+ * @brief out = a + b * s, e.g. integrating positions by velocities.
+ * 
+ * @param out Output vectors
+ * @param a Vectors to add to
+ * @param b Vectors to scale and add
+ * @param s Scalar
+ * @param n Number of vectors
+ */
+void lmVector2SoA_add_scaled(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, float s, size_t n);
+
+/**
+ * @brief out = a * s
+ * 
+ * @param out Output vectors
+ * @param a Vectors
+ * @param s Scalar
+ * @param n Number of vectors
+ */
+void lmVector2SoA_scale(lmVector2SoA out, lmVector2SoA a, float s, size_t n);
+
+/**
+ * @brief Rotate every vector by the same angle.
+ * 
+ * @param out Output vectors
+ * @param a Vectors
+ * @param angle Angle in radians
+ * @param n Number of vectors
+ */
+void lmVector2SoA_rotate(lmVector2SoA out, lmVector2SoA a, float angle, size_t n);
+
+/**
+ * @brief Rotate every vector by its own angle, given as cosines and sines.
+ * 
+ * @param out Output vectors
+ * @param a Vectors
+ * @param cos Cosines of the angles
+ * @param sin Sines of the angles
+ * @param n Number of vectors
+ */
+void lmVector2SoA_rotate_each(
+    lmVector2SoA out,
+    lmVector2SoA a,
+    const float *cos,
+    const float *sin,
+    size_t n
+);
+
+/**
+ * @brief Normalize vectors, zero vectors stay zero.
+ * 
+ * @param out Output vectors
+ * @param a Vectors
+ * @param n Number of vectors
+ */
+void lmVector2SoA_normalize(lmVector2SoA out, lmVector2SoA a, size_t n);
+
+/**
+ * @brief out = dot(a, b)
+ * 
+ * @param out Output scalars
+ * @param a Left-hand vectors
+ * @param b Right-hand vectors
+ * @param n Number of vectors
+ */
+void lmVector2SoA_dot(float *out, lmVector2SoA a, lmVector2SoA b, size_t n);
+
+/**
+ * @brief out = length(a)
+ * 
+ * @param out Output scalars
+ * @param a Vectors
+ * @param n Number of vectors
+ */
+void lmVector2SoA_length(float *out, lmVector2SoA a, size_t n);
+
+/**
+ * @brief out = a + (b - a) * t, e.g. interpolating between simulation states.
+ * 
+ * @param out Output vectors
+ * @param a Vectors at t = 0
+ * @param b Vectors at t = 1
+ * @param t Interpolation factor
+ * @param n Number of vectors
+ */
+void lmVector2SoA_lerp(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, float t, size_t n);
+
+/**
+ * @brief Axis-aligned bounding boxes of rotated rectangles.
+ * 
+ * @param min Output minimum corners
+ * @param max Output maximum corners
+ * @param center Centers of the rectangles
+ * @param half_size Half widths and heights of the rectangles
+ * @param cos Cosines of the rotation angles
+ * @param sin Sines of the rotation angles
+ * @param n Number of rectangles
+ */
+void lmVector2SoA_aabb(
+    lmVector2SoA min,
+    lmVector2SoA max,
+    lmVector2SoA center,
+    lmVector2SoA half_size,
+    const float *cos,
+    const float *sin,
+    size_t n
+);
+
+/**
+ * @brief Bounding box of all the vectors.
+ * 
+ * Both corners are zero if n is 0.
+ * 
+ * @param a Vectors
+ * @param n Number of vectors
+ * @param min Output minimum corner
+ * @param max Output maximum corner
+ */
+void lmVector2SoA_bounds(lmVector2SoA a, size_t n, lmVector2 *min, lmVector2 *max);
+
+
+#endif
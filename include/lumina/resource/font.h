@@ -12,6 +12,7 @@
 #define _LUMINA_FONT_H
 
 #include "lumina/_lumina.h"
+#include "lumina/core/string_id.h"
 
 
 /**
@@ -24,10 +25,35 @@
 typedef struct {
     TTF_Font *ttf;
     char *filepath;
+    lmStringId id; /**< ID of the filepath. */
     lm_uint32 size;
+    int style; /**< TTF_STYLE_* flags. */
 } lmFont;
 
 lmFont lmFont_load(const char *filepath, lm_uint32 size);
 
+/**
+ * @brief Load font from a file already read into memory.
+ * 
+ * SDL_ttf reads glyphs from the data lazily, so it must outlive the font.
+ * The same data can back any number of fonts, e.g. one per size. Unlike
+ * lmFont_load this doesn't error out, ttf is `NULL` if the font couldn't be
+ * opened.
+ * 
+ * @param filepath Path the data was read from
+ * @param data Font file data
+ * @param data_size Size of the data in bytes
+ * @param size Point size
+ * @param style TTF_STYLE_* flags
+ * @return lmFont
+ */
+lmFont lmFont_load_from_memory(
+    const char *filepath,
+    const void *data,
+    size_t data_size,
+    lm_uint32 size,
+    int style
+);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,143 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#ifndef _LUMINA_PACK_H
+#define _LUMINA_PACK_H
+
+#include "lumina/_lumina.h"
+
+
+/**
+ * @file resource/pack.h
+ * 
+ * @brief Packed asset archives.
+ */
+
+
+/*
+    Pack file layout, all integers little-endian:
+
+    header   magic "LMPK", version, entry count, reserved,
+             index offset (u64), strings offset (u64)
+    blobs    entry data, each aligned to 16 bytes
+    index    lmPackEntry array sorted by path hash
+    strings  entry paths, not zero-terminated
+
+    Packs are written by pack.py.
+*/
+
+#define LM_PACK_MAGIC "LMPK"
+#define LM_PACK_VERSION 1
+
+/**
+ * @brief Compression of a pack entry.
+ */
+typedef enum {
+    lmPackCompression_NONE = 0,
+    lmPackCompression_LZ4 = 1 /**< LZ4 block format. */
+} lmPackCompression;
+
+/**
+ * @brief Pack file header.
+ */
+typedef struct {
+    char magic[4];
+    lm_uint32 version;
+    lm_uint32 entry_count;
+    lm_uint32 reserved;
+    lm_uint64 index_offset;
+    lm_uint64 strings_offset;
+} lmPackHeader;
+
+/**
+ * @brief Pack index entry.
+ */
+typedef struct {
+    lm_uint64 path_hash; /**< FNV-1a hash of the path. */
+    lm_uint64 offset; /**< Offset of the data in the pack. */
+    lm_uint64 size; /**< Size of the stored data. */
+    lm_uint64 original_size; /**< Size of the data after decompression. */
+    lm_uint32 path_offset; /**< Offset of the path in the strings. */
+    lm_uint16 compression; /**< lmPackCompression of the data. */
+    lm_uint16 path_length; /**< Length of the path. */
+} lmPackEntry;
+
+/**
+ * @brief Opened pack archive.
+ * 
+ * The whole file is memory-mapped, so uncompressed entries are read in
+ * place without copying. On web it's read into memory instead.
+ */
+typedef struct {
+    const lm_uint8 *data; /**< Pack file contents. */
+    size_t size; /**< Size of the pack file in bytes. */
+    const lmPackEntry *entries; /**< Index. */
+    lm_uint32 entry_count; /**< Number of entries. */
+    const char *strings; /**< Path strings. */
+    void *mapping; /**< Platform file mapping handle, if any. */
+} lmPack;
+
+/**
+ * @brief Data of a pack entry.
+ */
+typedef struct {
+    const void *data; /**< Entry data. */
+    size_t size; /**< Size of the data in bytes. */
+    void *owned; /**< Decompressed copy of the data allocated with SDL_malloc, NULL if read in place. */
+} lmPackBlob;
+
+/**
+ * @brief Open pack archive. Returns `NULL` if it can't be opened or isn't a valid pack.
+ * 
+ * @param filepath Path of the pack file
+ * @return lmPack *
+ */
+lmPack *lmPack_open(const char *filepath);
+
+/**
+ * @brief Close pack archive.
+ * 
+ * Blobs read in place become invalid.
+ * 
+ * @param pack Pack to close
+ */
+void lmPack_close(lmPack *pack);
+
+/**
+ * @brief Find entry by path. Returns `NULL` if the pack doesn't have it.
+ * 
+ * @param pack Pack
+ * @param path Path of the entry
+ * @return const lmPackEntry *
+ */
+const lmPackEntry *lmPack_find(lmPack *pack, const char *path);
+
+/**
+ * @brief Read entry by path. Returns `false` if not found or corrupted.
+ * 
+ * Uncompressed entries point straight into the pack, compressed ones are
+ * decompressed into a new buffer. Free with lmPackBlob_free either way.
+ * 
+ * @param pack Pack
+ * @param path Path of the entry
+ * @param blob Blob to fill
+ * @return bool
+ */
+bool lmPack_read(lmPack *pack, const char *path, lmPackBlob *blob);
+
+/**
+ * @brief Free blob read from a pack.
+ * 
+ * @param blob Blob
+ */
+void lmPackBlob_free(lmPackBlob *blob);
+
+
+#endif
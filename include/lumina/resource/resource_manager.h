@@ -12,8 +12,13 @@
 #define _LUMINA_RESOURCE_MANAGER_H
 
 #include "lumina/_lumina.h"
+#include "lumina/collections/array.h"
 #include "lumina/collections/hashmap.h"
+#include "lumina/collections/vec.h"
+#include "lumina/collections/concurrent_hashmap.h"
+#include "lumina/core/file_watcher.h"
 #include "lumina/resource/font.h"
+#include "lumina/resource/pack.h"
 #include "lumina/resource/texture.h"
 
 
@@ -24,36 +29,355 @@
  */
 
 
+/**
+ * @brief State of an asynchronously loaded resource.
+ */
+typedef enum {
+    lmResourceState_LOADING, /**< Being read and decoded on a worker thread. */
+    lmResourceState_DECODED, /**< Decoded, waiting to be uploaded on the main thread. */
+    lmResourceState_READY, /**< Loaded and in the resource manager. */
+    lmResourceState_FAILED /**< Couldn't be loaded. */
+} lmResourceState;
+
+/**
+ * @brief Type of a resource.
+ */
+typedef enum {
+    lmResourceType_TEXTURE,
+    lmResourceType_FONT
+} lmResourceType;
+
+/**
+ * @brief Handle to an asynchronously loaded resource.
+ * 
+ * Owned by the resource manager. Valid until lmResourceHandle_free, or
+ * until the manager is freed if it's never released.
+ */
+typedef struct {
+    lmResourceType type; /**< Type of the resource. */
+    lmResourceState state; /**< Current state, use lmResourceHandle_get_state to read. */
+    char *filepath; /**< Path of the resource file. */
+    lm_uint32 size; /**< Point size for fonts. */
+    SDL_Surface *surface; /**< Decoded image for textures. */
+    void *file_data; /**< File contents for fonts, `NULL` if already loaded or in the pack. */
+    size_t file_size; /**< Size of file_data in bytes. */
+    void *resource; /**< lmTexture * or lmFont * once ready. */
+    void *manager; /**< Resource manager the handle belongs to. */
+    bool failed; /**< Decoding failed, set by the worker before queueing. */
+    bool reload; /**< Internal hot reload. */
+    bool released; /**< Free as soon as the load finishes. */
+} lmResourceHandle;
+
+/**
+ * @brief Font file loaded into memory, shared by every size and style of the font.
+ */
+typedef struct {
+    lmStringId id; /**< ID of the path. */
+    const char *filepath; /**< Interned path of the font file. */
+    void *data; /**< File contents. */
+    size_t size; /**< Size of the data in bytes. */
+    bool owned; /**< SDL_free the data with the manager, false if it's in the mapped pack. */
+} lmFontFile;
+
+/**
+ * @brief Resource manager.
+ * 
+ * Lookups are lock-free so any thread can get resources.
+ */
 typedef struct {
-    lmHashMap *fonts;
-    lmHashMap *textures;
+    lmConcurrentHashMap *fonts; /**< Fonts by path ID, size and style. */
+    lmHashMap *font_files; /**< Font file data by path ID, only used on the main thread. */
+    lmConcurrentHashMap *textures; /**< Textures by path ID. */
+    lmArray *handles; /**< Every unfreed async load handle. */
+    lmVec *decoded; /**< Handles decoded by workers, waiting for upload. Unbounded so jobs never block. */
+    SDL_mutex *decoded_lock; /**< Guards decoded. */
+    lmVec *uploads; /**< Decoded handles that didn't fit in the budget yet, in order. */
+    size_t upload_budget; /**< Bytes to upload per frame. */
+
+    size_t texture_budget; /**< Bytes of textures to keep loaded, 0 for no limit. */
+    size_t texture_bytes; /**< Bytes of textures currently loaded. */
+    lm_uint64 frame; /**< Frame counter for LRU eviction. */
+    SDL_threadID main_thread; /**< Only this thread can reload evicted textures. */
+
+    lmPack *pack; /**< Mounted pack, resources are read from it before the file system. */
+    lmVec *retired_packs; /**< Replaced packs, kept open for whatever still reads from them. */
+
+    lmFileWatcher *watcher; /**< Watches loaded files when hot reloading, `NULL` otherwise. */
+    lmVec *changed_files; /**< Paths changed this frame. */
 } lmResourceManager;
 
 lmResourceManager *lmResourceManager_new();
 
 void lmResourceManager_free(lmResourceManager *resource_manager);
 
+/**
+ * @brief Free replaced and removed resource entries.
+ * 
+ * Called by the game loop while no other thread is running.
+ * 
+ * @param resource_manager Resource manager
+ */
+void lmResourceManager_collect(lmResourceManager *resource_manager);
+
+/**
+ * @brief Mount pack archive. Returns `false` if it can't be opened.
+ * 
+ * Resources found in the pack are loaded from it, anything else still
+ * falls back to the file system. Replaces the previously mounted pack for
+ * new loads. The old one stays open until the manager is freed, since
+ * loaded fonts and in-flight loads may still read from it.
+ * 
+ * @param game Game
+ * @param filepath Path of the pack file
+ * @return bool
+ */
+bool lmResource_mount_pack(struct lmGame *game, const char *filepath);
+
+/**
+ * @brief Reload textures and fonts when their files change.
+ * 
+ * Every loaded file, and everything loaded afterwards, is watched except
+ * the ones in the mounted pack. Changed files are decoded on the thread
+ * pool like async loads and swapped in place, so existing lmTexture and
+ * lmFont pointers see the new data. Call from the main thread.
+ * 
+ * @param game Game
+ */
+void lmResource_enable_hot_reload(struct lmGame *game);
+
+/**
+ * @brief Load font with normal style.
+ * 
+ * The font file is read once and shared by every size and style loaded
+ * from it. Does nothing if the font is already loaded.
+ * 
+ * @param game Game
+ * @param filepath Path of the font file
+ * @param size Point size
+ */
 void lmResource_load_font(
     struct lmGame *game,
     char *filepath,
     lm_uint32 size
 );
 
+/**
+ * @brief Load font with the given style.
+ * 
+ * @param game Game
+ * @param filepath Path of the font file
+ * @param size Point size
+ * @param style TTF_STYLE_* flags
+ */
+void lmResource_load_font_styled(
+    struct lmGame *game,
+    char *filepath,
+    lm_uint32 size,
+    int style
+);
+
+/**
+ * @brief Get font with normal style, `NULL` if it was never loaded.
+ * 
+ * Hashes the name on every call, prefer lmResource_get_font_by_id with
+ * LM_SID in per-frame code.
+ * 
+ * @param game Game
+ * @param name Path the font was loaded from
+ * @param size Point size
+ * @return lmFont *
+ */
 lmFont *lmResource_get_font(
     struct lmGame *game,
     char *name,
     lm_uint32 size
 );
 
+/**
+ * @brief Get font loaded with the given style, `NULL` if it was never loaded.
+ * 
+ * @param game Game
+ * @param name Path the font was loaded from
+ * @param size Point size
+ * @param style TTF_STYLE_* flags
+ * @return lmFont *
+ */
+lmFont *lmResource_get_font_styled(
+    struct lmGame *game,
+    char *name,
+    lm_uint32 size,
+    int style
+);
+
+/**
+ * @brief Get font by the string ID of its path, `NULL` if it was never loaded.
+ * 
+ * @param game Game
+ * @param id String ID of the path
+ * @param size Point size
+ * @param style TTF_STYLE_* flags
+ * @return lmFont *
+ */
+lmFont *lmResource_get_font_by_id(
+    struct lmGame *game,
+    lmStringId id,
+    lm_uint32 size,
+    int style
+);
+
 void lmResource_load_texture(
     struct lmGame *game,
     char *filepath
 );
 
+/**
+ * @brief Get texture, `NULL` if it was never loaded.
+ * 
+ * Marks the texture as used this frame. If it was evicted it's reloaded
+ * here when called from the main thread, other threads get it with a
+ * `NULL` sdl_texture.
+ * 
+ * @param game Game
+ * @param name Path the texture was loaded from
+ * @return lmTexture *
+ */
 lmTexture *lmResource_get_texture(
     struct lmGame *game,
     char *name
 );
 
+/**
+ * @brief Get texture by the string ID of its path, `NULL` if it was never loaded.
+ * 
+ * Same as lmResource_get_texture without hashing the name.
+ * 
+ * @param game Game
+ * @param id String ID of the path
+ * @return lmTexture *
+ */
+lmTexture *lmResource_get_texture_by_id(
+    struct lmGame *game,
+    lmStringId id
+);
+
+/**
+ * @brief Get SDL texture to draw with, reloading it if it was evicted.
+ * 
+ * Components keep lmTexture pointers across frames, so draw through this
+ * rather than reading sdl_texture directly. Marks the texture as used this
+ * frame. Off the main thread an evicted texture gives `NULL`.
+ * 
+ * @param game Game
+ * @param texture Texture
+ * @return SDL_Texture *
+ */
+SDL_Texture *lmResource_use_texture(
+    struct lmGame *game,
+    lmTexture *texture
+);
+
+/**
+ * @brief Get texture and keep it from being evicted until released.
+ * 
+ * @param game Game
+ * @param name Path the texture was loaded from
+ * @return lmTexture *
+ */
+lmTexture *lmResource_acquire_texture(
+    struct lmGame *game,
+    char *name
+);
+
+/**
+ * @brief Release a reference taken with lmResource_acquire_texture.
+ * 
+ * Unreferenced textures can be evicted when over the texture budget.
+ * Raises an error if the texture has no references left.
+ * 
+ * @param game Game
+ * @param texture Texture
+ */
+void lmResource_release_texture(
+    struct lmGame *game,
+    lmTexture *texture
+);
+
+/**
+ * @brief Start loading texture in the background.
+ * 
+ * The image is decoded on a worker thread and uploaded to the renderer on
+ * the main thread within the per-frame upload budget. Poll the handle or
+ * lmResource_get_texture to see when it's ready. Call from the main thread.
+ * 
+ * @param game Game
+ * @param filepath Path of the image file
+ * @return lmResourceHandle *
+ */
+lmResourceHandle *lmResource_load_texture_async(
+    struct lmGame *game,
+    const char *filepath
+);
+
+/**
+ * @brief Start loading font in the background.
+ * 
+ * The file is read on a worker thread and opened on the main thread within
+ * the per-frame upload budget. Call from the main thread.
+ * 
+ * @param game Game
+ * @param filepath Path of the font file
+ * @param size Point size
+ * @return lmResourceHandle *
+ */
+lmResourceHandle *lmResource_load_font_async(
+    struct lmGame *game,
+    const char *filepath,
+    lm_uint32 size
+);
+
+/**
+ * @brief Upload decoded resources until the frame's budget is spent.
+ * 
+ * Called by the game loop on the main thread.
+ * 
+ * @param game Game
+ */
+void lmResource_update(struct lmGame *game);
+
+/**
+ * @brief Get state of an async load.
+ * 
+ * @param handle Handle
+ * @return lmResourceState
+ */
+lmResourceState lmResourceHandle_get_state(lmResourceHandle *handle);
+
+/**
+ * @brief Get the loaded texture, `NULL` if not ready.
+ * 
+ * @param handle Handle
+ * @return lmTexture *
+ */
+lmTexture *lmResourceHandle_get_texture(lmResourceHandle *handle);
+
+/**
+ * @brief Get the loaded font, `NULL` if not ready.
+ * 
+ * @param handle Handle
+ * @return lmFont *
+ */
+lmFont *lmResourceHandle_get_font(lmResourceHandle *handle);
+
+/**
+ * @brief Free handle. The resource it loaded stays in the manager.
+ * 
+ * If the load hasn't finished yet, the handle is freed once it does.
+ * Call from the main thread.
+ * 
+ * @param game Game
+ * @param handle Handle to free
+ */
+void lmResourceHandle_free(struct lmGame *game, lmResourceHandle *handle);
+
 
 #endif
\ No newline at end of file
@@ -13,6 +13,7 @@
 
 #include "lumina/_lumina.h"
 #include "lumina/core/window.h"
+#include "lumina/core/string_id.h"
 
 
 /**
@@ -26,11 +27,23 @@
  * @brief 2D texture.
  */
 typedef struct {
-    SDL_Texture *sdl_texture;
+    SDL_Texture *sdl_texture; /**< NULL while evicted by the resource manager. */
     const char *filepath;
+    lmStringId id; /**< ID of the filepath. */
+    size_t bytes; /**< Estimated GPU memory used by the texture. */
+    lm_uint32 refcount; /**< Number of references keeping the texture loaded. */
+    lm_uint64 last_used; /**< Resource manager frame this texture was last used on. */
 } lmTexture;
 
 lmTexture lmTexture_load(lmWindow *window, const char *filepath);
 
+/**
+ * @brief Estimate GPU memory used by a texture, assuming 4 bytes per pixel.
+ * 
+ * @param sdl_texture SDL texture
+ * @return size_t
+ */
+size_t lm_texture_bytes(SDL_Texture *sdl_texture);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,185 @@
+"""
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+"""
+
+import sys
+import os
+import struct
+from pathlib import Path
+
+
+"""
+    Writes lmPack archives, see include/lumina/resource/pack.h for the layout.
+
+    Usage: python pack.py <assets directory> <output file> [prefix]
+
+    Entry paths are the file paths relative to the assets directory, joined
+    to the prefix ("assets" by default) with forward slashes.
+"""
+
+
+PACK_MAGIC = b"LMPK"
+PACK_VERSION = 1
+
+COMPRESSION_NONE = 0
+COMPRESSION_LZ4 = 1
+
+HEADER_FORMAT = "<4sIIIQQ"
+ENTRY_FORMAT = "<QQQQIHH"
+
+BLOB_ALIGNMENT = 16
+
+# Already compressed formats aren't worth another pass
+STORE_ONLY = {".png", ".jpg", ".jpeg", ".ogg", ".mp3"}
+
+FNV_BASIS = 0xcbf29ce484222325
+FNV_PRIME = 0x100000001b3
+
+
+def fnv1a(path: str) -> int:
+    """ Same as lm_fnv1a, including char being signed. """
+    h = FNV_BASIS
+    for byte in path.encode("utf-8"):
+        if byte > 127:
+            byte |= 0xffffffffffffff00
+        h ^= byte
+        h = (h * FNV_PRIME) & 0xffffffffffffffff
+    return h
+
+
+def _lz4_length(out: bytearray, length: int):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _lz4_sequence(out: bytearray, literals: bytes, offset: int, match_length: int):
+    lit_len = len(literals)
+    token = min(lit_len, 15) << 4
+    if offset:
+        token |= min(match_length - 4, 15)
+    out.append(token)
+
+    if lit_len >= 15:
+        _lz4_length(out, lit_len - 15)
+    out += literals
+
+    if offset:
+        out += struct.pack("<H", offset)
+        if match_length - 4 >= 15:
+            _lz4_length(out, match_length - 19)
+
+
+def lz4_compress(data: bytes) -> bytes:
+    """ Greedy LZ4 block compressor. """
+    out = bytearray()
+    table = {}
+    n = len(data)
+
+    # The format requires the last match to start 12 bytes before the end
+    # and the last 5 bytes to be literals.
+    match_limit = n - 12
+    end_literals = n - 5
+
+    anchor = 0
+    i = 0
+    while i < match_limit:
+        seq = data[i:i + 4]
+        candidate = table.get(seq)
+        table[seq] = i
+
+        if candidate is None or i - candidate > 0xffff:
+            i += 1
+            continue
+
+        length = 4
+        while i + length < end_literals and data[candidate + length] == data[i + length]:
+            length += 1
+
+        _lz4_sequence(out, data[anchor:i], i - candidate, length)
+
+        i += length
+        anchor = i
+
+    _lz4_sequence(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def write_pack(files: dict, output: Path):
+    """ Write pack from a dict of entry path -> file path. """
+    header_size = struct.calcsize(HEADER_FORMAT)
+
+    blobs = bytearray()
+    entries = []
+    strings = bytearray()
+
+    for path, file in sorted(files.items()):
+        with open(file, "rb") as f:
+            data = f.read()
+
+        compression = COMPRESSION_NONE
+        stored = data
+        if Path(file).suffix.lower() not in STORE_ONLY:
+            compressed = lz4_compress(data)
+            if len(compressed) < len(data):
+                compression = COMPRESSION_LZ4
+                stored = compressed
+
+        offset = header_size + len(blobs)
+        offset += -offset % BLOB_ALIGNMENT
+        blobs += bytes(offset - header_size - len(blobs))
+        blobs += stored
+
+        encoded_path = path.encode("utf-8")
+        entries.append((
+            fnv1a(path), offset, len(stored), len(data),
+            len(strings), compression, len(encoded_path)
+        ))
+        strings += encoded_path
+
+    entries.sort(key=lambda entry: entry[0])
+
+    index_offset = header_size + len(blobs)
+    padding = -index_offset % 8
+    index_offset += padding
+    strings_offset = index_offset + len(entries) * struct.calcsize(ENTRY_FORMAT)
+
+    with open(output, "wb") as f:
+        f.write(struct.pack(
+            HEADER_FORMAT, PACK_MAGIC, PACK_VERSION, len(entries), 0,
+            index_offset, strings_offset
+        ))
+        f.write(blobs)
+        f.write(bytes(padding))
+        for entry in entries:
+            f.write(struct.pack(ENTRY_FORMAT, *entry))
+        f.write(strings)
+
+
+def pack_directory(directory: Path, output: Path, prefix: str = "assets"):
+    files = {}
+    for root, _, filenames in os.walk(directory):
+        for filename in filenames:
+            file = Path(root) / filename
+            path = file.relative_to(directory).as_posix()
+            if prefix:
+                path = f"{prefix}/{path}"
+            files[path] = file
+
+    write_pack(files, output)
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 3:
+        print("Usage: python pack.py <assets directory> <output file> [prefix]")
+        sys.exit(1)
+
+    prefix = sys.argv[3] if len(sys.argv) > 3 else "assets"
+    pack_directory(Path(sys.argv[1]), Path(sys.argv[2]), prefix)
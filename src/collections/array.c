@@ -8,6 +8,8 @@
 
 */
 
+#define LM_MEMORY_TAG lmMemoryTag_COLLECTIONS
+
 #include "lumina/collections/array.h"
 
 
@@ -24,9 +26,9 @@ lmArray *lmArray_new() {
 
     array->size = 0;
     array->max = 0;
-    array->data = (void **)malloc(sizeof(void *));
+    array->data = (void **)LM_MALLOC(sizeof(void *));
     if (!array->data) {
-        free(array);
+        LM_FREE(array);
         return NULL;
     }
 
@@ -34,10 +36,10 @@ lmArray *lmArray_new() {
 }
 
 void lmArray_free(lmArray *array) {
-    free(array->data);
+    LM_FREE(array->data);
     array->data = NULL;
     array->size = 0;
-    free(array);
+    LM_FREE(array);
 }
 
 void lmArray_free_each(lmArray *array, void (free_func)(void *)) {
@@ -46,33 +48,29 @@ void lmArray_free_each(lmArray *array, void (free_func)(void *)) {
 }
 
 void lmArray_add(lmArray *array, void *elem) {
-    // Only reallocate when max capacity is reached
+    // Only reallocate when max capacity is reached, doubling it so appending
+    // stays amortized O(1)
     if (array->size == array->max) {
-        array->size++;
-        array->max++;
-        array->data = (void **)realloc(array->data, array->size * sizeof(void *));
-    }
-    else {
-        array->size++;
+        size_t new_max = array->max ? array->max * 2 : 8;
+        void **new_data = (void **)LM_REALLOC(array->data, new_max * sizeof(void *));
+        LM_MEMORY_ASSERT(new_data);
+        array->data = new_data;
+        array->max = new_max;
     }
 
-    array->data[array->size - 1] = elem;
+    array->data[array->size++] = elem;
 }
 
 void *lmArray_pop(lmArray *array, size_t index) {
-    for (size_t i = 0; i < array->size; i++) {
-        if (i == index) {
-            array->size--;
-            void *elem = array->data[i];
+    if (index >= array->size) return NULL;
 
-            array->data[i] = array->data[array->size];
-            array->data[array->size] = NULL;
+    array->size--;
+    void *elem = array->data[index];
 
-            return elem;
-        }
-    }
+    array->data[index] = array->data[array->size];
+    array->data[array->size] = NULL;
 
-    return NULL;
+    return elem;
 }
 
 size_t lmArray_remove(lmArray *array, void *elem) {
@@ -98,17 +96,7 @@ void lmArray_clear(lmArray *array, void (free_func)(void *)) {
         Maybe a separate parameter for this?
     */
 
-    if (array->size == 0) return;
-   
-    if (!free_func) {
-        while (array->size > 0) {
-            lmArray_pop(array, 0);
-        }
-    }
+    if (free_func) lmArray_free_each(array, free_func);
 
-    else {
-        while (array->size > 0) {
-            free_func(lmArray_pop(array, 0));
-        }
-    }
-}
\ No newline at end of file
+    array->size = 0;
+}
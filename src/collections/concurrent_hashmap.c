@@ -0,0 +1,366 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_COLLECTIONS
+
+#include "lumina/collections/concurrent_hashmap.h"
+#include "lumina/math/hash.h"
+
+
+/**
+ * @file collections/concurrent_hashmap.c
+ * 
+ * @brief Read-mostly hash map that is safe to share between threads.
+ */
+
+
+/*
+    Each item is stored after a node header holding its hash, padded to
+    max_align_t so the item keeps malloc's alignment. The hash never changes
+    after the node is published, so readers can check it without tearing.
+*/
+typedef union {
+    struct {
+        void *retired_next;
+        lm_uint64 hash;
+    } info;
+    max_align_t _align;
+} _lmConcurrentHashMapNode;
+
+struct _lmConcurrentHashMapTable {
+    size_t nbuckets;
+    size_t mask;
+    struct _lmConcurrentHashMapTable *retired_next;
+    _lmConcurrentHashMapNode **nodes;
+};
+
+// Marks removed slots so probe sequences going over them are not cut short
+static _lmConcurrentHashMapNode _lm_tombstone;
+#define _LM_TOMBSTONE (&_lm_tombstone)
+
+
+static inline void *_lmNode_item(_lmConcurrentHashMapNode *node) {
+    return (char *)node + sizeof(_lmConcurrentHashMapNode);
+}
+
+static inline struct _lmConcurrentHashMapTable *_lmConcurrentHashMap_alloc_table(size_t nbuckets) {
+    size_t nodes_size = sizeof(_lmConcurrentHashMapNode *) * nbuckets;
+
+    struct _lmConcurrentHashMapTable *table = LM_MALLOC(sizeof(struct _lmConcurrentHashMapTable) + nodes_size);
+    if (!table) return NULL;
+
+    table->nbuckets = nbuckets;
+    table->mask = nbuckets - 1;
+    table->retired_next = NULL;
+    table->nodes = (_lmConcurrentHashMapNode **)(table + 1);
+    memset(table->nodes, 0, nodes_size);
+
+    return table;
+}
+
+static inline void _lmConcurrentHashMap_retire_node(
+    lmConcurrentHashMap *hashmap,
+    _lmConcurrentHashMapNode *node
+) {
+    node->info.retired_next = hashmap->retired_nodes;
+    hashmap->retired_nodes = node;
+}
+
+/**
+ * @brief Find the slot of the item with the same key, or -1. Caller holds the lock.
+ */
+static inline size_t _lmConcurrentHashMap_find(
+    lmConcurrentHashMap *hashmap,
+    struct _lmConcurrentHashMapTable *table,
+    void *key,
+    lm_uint64 hash
+) {
+    size_t i = hash & table->mask;
+    while (true) {
+        _lmConcurrentHashMapNode *node = table->nodes[i];
+        if (!node) return (size_t)-1;
+
+        if (node != _LM_TOMBSTONE && node->info.hash == hash) {
+            if (!hashmap->compare_func ||
+                hashmap->compare_func(_lmNode_item(node), key) == 0)
+                return i;
+        }
+
+        i = (i + 1) & table->mask;
+    }
+}
+
+/**
+ * @brief Rehash into a new table and publish it. Caller holds the lock.
+ */
+static inline bool _lmConcurrentHashMap_resize(lmConcurrentHashMap *hashmap, size_t new_cap) {
+    struct _lmConcurrentHashMapTable *old = hashmap->table;
+    struct _lmConcurrentHashMapTable *table = _lmConcurrentHashMap_alloc_table(new_cap);
+    if (!table) return false;
+
+    for (size_t i = 0; i < old->nbuckets; i++) {
+        _lmConcurrentHashMapNode *node = old->nodes[i];
+        if (!node || node == _LM_TOMBSTONE) continue;
+
+        size_t j = node->info.hash & table->mask;
+        while (table->nodes[j]) j = (j + 1) & table->mask;
+        table->nodes[j] = node;
+    }
+
+    // Readers still probing the old table see it unchanged
+    __atomic_store_n(&hashmap->table, table, __ATOMIC_RELEASE);
+
+    old->retired_next = hashmap->retired_tables;
+    hashmap->retired_tables = old;
+
+    hashmap->deleted = 0;
+    hashmap->growat = new_cap / 2;
+
+    return true;
+}
+
+
+lmConcurrentHashMap *lmConcurrentHashMap_new(
+    size_t item_size,
+    size_t cap,
+    lm_uint64 (*hash_func)(void *item),
+    int (*compare_func)(void *a, void *b)
+) {
+    // Capacity must be a power of 2 and higher than the default value.
+    size_t ncap = 16;
+    while (ncap < cap) ncap *= 2;
+
+    lmConcurrentHashMap *hashmap = LM_NEW(lmConcurrentHashMap);
+    if (!hashmap) return NULL;
+
+    hashmap->table = _lmConcurrentHashMap_alloc_table(ncap);
+    hashmap->write_lock = SDL_CreateMutex();
+    if (!hashmap->table || !hashmap->write_lock) {
+        LM_FREE(hashmap->table);
+        if (hashmap->write_lock) SDL_DestroyMutex(hashmap->write_lock);
+        LM_FREE(hashmap);
+        return NULL;
+    }
+
+    hashmap->elsize = item_size;
+    hashmap->cap = ncap;
+    hashmap->hash_func = hash_func;
+    hashmap->compare_func = compare_func;
+    hashmap->count = 0;
+    hashmap->deleted = 0;
+    // Linear probing stays short below half load
+    hashmap->growat = ncap / 2;
+    hashmap->oom = false;
+    hashmap->retired_nodes = NULL;
+    hashmap->retired_tables = NULL;
+
+    return hashmap;
+}
+
+void lmConcurrentHashMap_free(lmConcurrentHashMap *hashmap) {
+    struct _lmConcurrentHashMapTable *table = hashmap->table;
+    for (size_t i = 0; i < table->nbuckets; i++) {
+        if (table->nodes[i] && table->nodes[i] != _LM_TOMBSTONE)
+            LM_FREE(table->nodes[i]);
+    }
+
+    lmConcurrentHashMap_collect(hashmap);
+
+    LM_FREE(table);
+    SDL_DestroyMutex(hashmap->write_lock);
+    LM_FREE(hashmap);
+}
+
+void lmConcurrentHashMap_clear(lmConcurrentHashMap *hashmap) {
+    SDL_LockMutex(hashmap->write_lock);
+
+    struct _lmConcurrentHashMapTable *table = _lmConcurrentHashMap_alloc_table(hashmap->cap);
+    if (!table) {
+        // Fall back to removing entries in place
+        struct _lmConcurrentHashMapTable *current = hashmap->table;
+        for (size_t i = 0; i < current->nbuckets; i++) {
+            _lmConcurrentHashMapNode *node = current->nodes[i];
+            if (!node || node == _LM_TOMBSTONE) continue;
+
+            __atomic_store_n(&current->nodes[i], _LM_TOMBSTONE, __ATOMIC_RELEASE);
+            _lmConcurrentHashMap_retire_node(hashmap, node);
+            hashmap->deleted++;
+        }
+
+        hashmap->count = 0;
+        SDL_UnlockMutex(hashmap->write_lock);
+        return;
+    }
+
+    struct _lmConcurrentHashMapTable *old = hashmap->table;
+    __atomic_store_n(&hashmap->table, table, __ATOMIC_RELEASE);
+
+    for (size_t i = 0; i < old->nbuckets; i++) {
+        _lmConcurrentHashMapNode *node = old->nodes[i];
+        if (node && node != _LM_TOMBSTONE)
+            _lmConcurrentHashMap_retire_node(hashmap, node);
+    }
+
+    old->retired_next = hashmap->retired_tables;
+    hashmap->retired_tables = old;
+
+    hashmap->count = 0;
+    hashmap->deleted = 0;
+    hashmap->growat = hashmap->cap / 2;
+
+    SDL_UnlockMutex(hashmap->write_lock);
+}
+
+void *lmConcurrentHashMap_get(lmConcurrentHashMap *hashmap, void *key) {
+    if (!hashmap->hash_func)
+        return NULL;
+
+    lm_uint64 hash = lm_u64mix(hashmap->hash_func(key));
+
+    struct _lmConcurrentHashMapTable *table = __atomic_load_n(&hashmap->table, __ATOMIC_ACQUIRE);
+
+    size_t i = hash & table->mask;
+    while (true) {
+        _lmConcurrentHashMapNode *node = __atomic_load_n(&table->nodes[i], __ATOMIC_ACQUIRE);
+        if (!node) return NULL;
+
+        if (node != _LM_TOMBSTONE && node->info.hash == hash) {
+            void *item = _lmNode_item(node);
+            if (!hashmap->compare_func || hashmap->compare_func(item, key) == 0)
+                return item;
+        }
+
+        i = (i + 1) & table->mask;
+    }
+}
+
+void *lmConcurrentHashMap_set(lmConcurrentHashMap *hashmap, void *item) {
+    if (!hashmap->hash_func)
+        return NULL;
+
+    // Hash and copy the item before taking the lock
+    lm_uint64 hash = lm_u64mix(hashmap->hash_func(item));
+
+    _lmConcurrentHashMapNode *node = LM_MALLOC(sizeof(_lmConcurrentHashMapNode) + hashmap->elsize);
+    if (!node) {
+        // Other writers update the flag under the lock too
+        SDL_LockMutex(hashmap->write_lock);
+        hashmap->oom = true;
+        SDL_UnlockMutex(hashmap->write_lock);
+        return NULL;
+    }
+
+    node->info.retired_next = NULL;
+    node->info.hash = hash;
+    memcpy(_lmNode_item(node), item, hashmap->elsize);
+
+    SDL_LockMutex(hashmap->write_lock);
+
+    hashmap->oom = false;
+
+    size_t index = _lmConcurrentHashMap_find(hashmap, hashmap->table, item, hash);
+    if (index != (size_t)-1) {
+        _lmConcurrentHashMapNode *old = hashmap->table->nodes[index];
+        __atomic_store_n(&hashmap->table->nodes[index], node, __ATOMIC_RELEASE);
+        _lmConcurrentHashMap_retire_node(hashmap, old);
+
+        SDL_UnlockMutex(hashmap->write_lock);
+        return _lmNode_item(old);
+    }
+
+    if (hashmap->count + hashmap->deleted + 1 > hashmap->growat) {
+        // If most of the used slots are tombstones, rehashing at the same
+        // size is enough to clean them up.
+        size_t new_cap = hashmap->table->nbuckets;
+        if (hashmap->count + 1 > hashmap->growat / 2) new_cap *= 2;
+
+        if (!_lmConcurrentHashMap_resize(hashmap, new_cap)) {
+            hashmap->oom = true;
+            SDL_UnlockMutex(hashmap->write_lock);
+            LM_FREE(node);
+            return NULL;
+        }
+    }
+
+    struct _lmConcurrentHashMapTable *table = hashmap->table;
+    size_t i = hash & table->mask;
+    while (table->nodes[i] && table->nodes[i] != _LM_TOMBSTONE)
+        i = (i + 1) & table->mask;
+
+    if (table->nodes[i] == _LM_TOMBSTONE) hashmap->deleted--;
+
+    __atomic_store_n(&table->nodes[i], node, __ATOMIC_RELEASE);
+    hashmap->count++;
+
+    SDL_UnlockMutex(hashmap->write_lock);
+    return NULL;
+}
+
+void *lmConcurrentHashMap_remove(lmConcurrentHashMap *hashmap, void *key) {
+    if (!hashmap->hash_func)
+        return NULL;
+
+    lm_uint64 hash = lm_u64mix(hashmap->hash_func(key));
+
+    SDL_LockMutex(hashmap->write_lock);
+
+    size_t index = _lmConcurrentHashMap_find(hashmap, hashmap->table, key, hash);
+    if (index == (size_t)-1) {
+        SDL_UnlockMutex(hashmap->write_lock);
+        return NULL;
+    }
+
+    _lmConcurrentHashMapNode *node = hashmap->table->nodes[index];
+    __atomic_store_n(&hashmap->table->nodes[index], _LM_TOMBSTONE, __ATOMIC_RELEASE);
+    _lmConcurrentHashMap_retire_node(hashmap, node);
+
+    hashmap->count--;
+    hashmap->deleted++;
+
+    SDL_UnlockMutex(hashmap->write_lock);
+    return _lmNode_item(node);
+}
+
+bool lmConcurrentHashMap_iter(lmConcurrentHashMap *hashmap, size_t *index, void **item) {
+    struct _lmConcurrentHashMapTable *table = __atomic_load_n(&hashmap->table, __ATOMIC_ACQUIRE);
+
+    while (*index < table->nbuckets) {
+        _lmConcurrentHashMapNode *node = __atomic_load_n(&table->nodes[(*index)++], __ATOMIC_ACQUIRE);
+
+        if (node && node != _LM_TOMBSTONE) {
+            *item = _lmNode_item(node);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void lmConcurrentHashMap_collect(lmConcurrentHashMap *hashmap) {
+    SDL_LockMutex(hashmap->write_lock);
+
+    _lmConcurrentHashMapNode *node = hashmap->retired_nodes;
+    while (node) {
+        _lmConcurrentHashMapNode *next = node->info.retired_next;
+        LM_FREE(node);
+        node = next;
+    }
+    hashmap->retired_nodes = NULL;
+
+    struct _lmConcurrentHashMapTable *table = hashmap->retired_tables;
+    while (table) {
+        struct _lmConcurrentHashMapTable *next = table->retired_next;
+        LM_FREE(table);
+        table = next;
+    }
+    hashmap->retired_tables = NULL;
+
+    SDL_UnlockMutex(hashmap->write_lock);
+}
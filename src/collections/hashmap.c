@@ -8,8 +8,19 @@
 
 */
 
+#define LM_MEMORY_TAG lmMemoryTag_COLLECTIONS
+
 #include <string.h>
 #include "lumina/collections/hashmap.h"
+#include "lumina/math/hash.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+    #define _LM_HASHMAP_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define _LM_HASHMAP_NEON
+#endif
 
 
 /**
@@ -20,71 +31,264 @@
  * Thanks to @tidwall for their great hash map implementation that served as
  * a strong foundation for this one.
  * (https://github.com/tidwall/hashmap.c)
+ * 
+ * The table layout and probing scheme follow Abseil's Swiss tables.
+ * (https://abseil.io/about/design/swisstables)
  */
 
 
-static inline lmHashMapBucket *_lmHashMap_get_bucket_at(
-    lmHashMap *map,
-    size_t index
-) {
-    return (lmHashMapBucket *)(((char *)map->buckets) + (map->bucketsz * index));
+/*
+    Group operations
+
+    Each returns a bitmask where bit N is set if the control byte at
+    group[N] matches.
+*/
+
+typedef lm_uint32 _lmBitMask;
+
+#ifdef _LM_HASHMAP_NEON
+
+static inline _lmBitMask _lm_neon_movemask(uint8x16_t cmp) {
+    // NEON has no movemask, weight each lane by its bit and sum the halves
+    static const lm_uint8 bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t masked = vandq_u8(cmp, vld1q_u8(bits));
+    return vaddv_u8(vget_low_u8(masked)) | ((_lmBitMask)vaddv_u8(vget_high_u8(masked)) << 8);
 }
 
-static inline void *_lmHashMap_get_bucket_item(lmHashMapBucket *entry) {
-    return ((char *)entry) + sizeof(lmHashMapBucket);
+#endif
+
+static inline _lmBitMask _lmGroup_match(const lm_uint8 *group, lm_uint8 value) {
+    #if defined(_LM_HASHMAP_SSE2)
+
+        __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)value)));
+
+    #elif defined(_LM_HASHMAP_NEON)
+
+        return _lm_neon_movemask(vceqq_u8(vld1q_u8(group), vdupq_n_u8(value)));
+
+    #else
+
+        _lmBitMask mask = 0;
+        for (size_t i = 0; i < LM_HASHMAP_GROUP_WIDTH; i++)
+            mask |= (_lmBitMask)(group[i] == value) << i;
+        return mask;
+
+    #endif
 }
 
-static inline lm_uint64 _lmHashMap_clip(lm_uint64 hash) {
-    return hash & 0xFFFFFFFFFFFF;
+static inline _lmBitMask _lmGroup_match_empty(const lm_uint8 *group) {
+    return _lmGroup_match(group, LM_HASHMAP_CTRL_EMPTY);
 }
 
-static inline bool _lmHashMap_resize(lmHashMap *hashmap, size_t new_cap) {
-    lmHashMap *hashmap2 = lmHashMap_new(hashmap->elsize, new_cap, hashmap->hash_func);
-    if (!hashmap2) return false;
+static inline _lmBitMask _lmGroup_match_empty_or_deleted(const lm_uint8 *group) {
+    // Only empty and deleted slots have the high bit set
+    #if defined(_LM_HASHMAP_SSE2)
 
-    for (size_t i = 0; i < hashmap->nbuckets; i++) {
-        lmHashMapBucket *entry = _lmHashMap_get_bucket_at(hashmap, i);
-        if (!entry->dib)continue;
-        entry->dib = 1;
+        return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
 
-        size_t j = entry->hash & hashmap2->mask;
-        while (true) {
-            lmHashMapBucket *bucket = _lmHashMap_get_bucket_at(hashmap2, j);
+    #elif defined(_LM_HASHMAP_NEON)
 
-            if (bucket->dib == 0) {
-                memcpy(bucket, entry, hashmap->bucketsz);
-                break;
-            }
+        return _lm_neon_movemask(vcltzq_s8(vreinterpretq_s8_u8(vld1q_u8(group))));
 
-            if (bucket->dib < entry->dib) {
-                memcpy(hashmap2->spare, bucket, hashmap->bucketsz);
-                memcpy(bucket, entry, hashmap->bucketsz);
-                memcpy(entry, hashmap2->spare, hashmap->bucketsz);
+    #else
+
+        _lmBitMask mask = 0;
+        for (size_t i = 0; i < LM_HASHMAP_GROUP_WIDTH; i++)
+            mask |= (_lmBitMask)(group[i] >> 7) << i;
+        return mask;
+
+    #endif
+}
+
+
+/*
+    Hashes from callbacks are mixed with lm_u64mix before use, since ones like
+    the identity on entity IDs leave both the high and low bits we use here
+    poorly distributed.
+*/
+
+static inline size_t _lmHashMap_h1(lm_uint64 hash) {
+    return (size_t)(hash >> 7);
+}
+
+static inline lm_uint8 _lmHashMap_h2(lm_uint64 hash) {
+    return (lm_uint8)(hash & 0x7F);
+}
+
+static inline void *_lmHashMap_get_slot(lmHashMap *hashmap, size_t index) {
+    return ((char *)hashmap->slots) + (hashmap->elsize * index);
+}
+
+static inline void _lmHashMap_set_ctrl(lmHashMap *hashmap, size_t index, lm_uint8 value) {
+    hashmap->ctrl[index] = value;
+
+    // Keep the mirrored first group in sync so group loads can wrap around
+    if (index < LM_HASHMAP_GROUP_WIDTH)
+        hashmap->ctrl[hashmap->nbuckets + index] = value;
+}
+
+/**
+ * @brief Allocate hashes, item storage and control bytes of a table in one block.
+ */
+static inline bool _lmHashMap_alloc_table(lmHashMap *hashmap, size_t nbuckets) {
+    size_t hashes_size = sizeof(lm_uint64) * nbuckets;
+    size_t slots_size = hashmap->elsize * nbuckets;
+    size_t ctrl_size = nbuckets + LM_HASHMAP_GROUP_WIDTH;
+
+    lm_uint64 *hashes = LM_MALLOC(hashes_size + slots_size + ctrl_size);
+    if (!hashes) return false;
+
+    hashmap->hashes = hashes;
+    hashmap->slots = (char *)hashes + hashes_size;
+    hashmap->ctrl = (lm_uint8 *)hashmap->slots + slots_size;
+    memset(hashmap->ctrl, LM_HASHMAP_CTRL_EMPTY, ctrl_size);
+
+    hashmap->nbuckets = nbuckets;
+    hashmap->mask = nbuckets - 1;
+    hashmap->deleted = 0;
+
+    return true;
+}
+
+/**
+ * @brief Find the slot of the item with the same key, or -1.
+ */
+static inline size_t _lmHashMap_find(lmHashMap *hashmap, void *key, lm_uint64 hash) {
+    lm_uint8 h2 = _lmHashMap_h2(hash);
+    size_t pos = _lmHashMap_h1(hash) & hashmap->mask;
+    size_t step = 0;
+
+    while (true) {
+        const lm_uint8 *group = hashmap->ctrl + pos;
+
+        _lmBitMask match = _lmGroup_match(group, h2);
+        while (match) {
+            size_t index = (pos + __builtin_ctz(match)) & hashmap->mask;
+
+            // Only touch the item storage when the full hash matches too
+            if (hashmap->hashes[index] == hash) {
+                if (!hashmap->compare_func ||
+                    hashmap->compare_func(_lmHashMap_get_slot(hashmap, index), key) == 0)
+                    return index;
             }
 
-            j = (j + 1) & hashmap2->mask;
-            entry->dib += 1;
+            match &= match - 1;
         }
+
+        // An empty slot ends the probe sequence, the item would be here
+        if (_lmGroup_match_empty(group)) return (size_t)-1;
+
+        // Triangular probing over groups visits every group once
+        step += LM_HASHMAP_GROUP_WIDTH;
+        pos = (pos + step) & hashmap->mask;
     }
+}
 
-    free(hashmap->buckets);
+/**
+ * @brief Find the first empty or deleted slot for the given hash.
+ */
+static inline size_t _lmHashMap_find_insert_slot(lmHashMap *hashmap, lm_uint64 hash) {
+    size_t pos = _lmHashMap_h1(hash) & hashmap->mask;
+    size_t step = 0;
 
-    hashmap->buckets = hashmap2->buckets;
-    hashmap->nbuckets = hashmap2->nbuckets;
-    hashmap->mask = hashmap2->mask;
-    hashmap->growat = hashmap2->growat;
-    hashmap->shrinkat = hashmap2->shrinkat;
+    while (true) {
+        _lmBitMask match = _lmGroup_match_empty_or_deleted(hashmap->ctrl + pos);
+        if (match)
+            return (pos + __builtin_ctz(match)) & hashmap->mask;
 
-    free(hashmap2);
+        step += LM_HASHMAP_GROUP_WIDTH;
+        pos = (pos + step) & hashmap->mask;
+    }
+}
+
+static inline void _lmHashMap_update_thresholds(lmHashMap *hashmap) {
+    hashmap->growat = (size_t)(hashmap->nbuckets * hashmap->max_load);
+    hashmap->shrinkat = (size_t)(hashmap->nbuckets * hashmap->min_load);
+}
+
+/**
+ * @brief Smallest table size that holds count items under the max load factor.
+ */
+static inline size_t _lmHashMap_buckets_for(lmHashMap *hashmap, size_t count) {
+    size_t nbuckets = 16;
+    while ((size_t)(nbuckets * hashmap->max_load) <= count) nbuckets *= 2;
+    return nbuckets;
+}
+
+static inline bool _lmHashMap_resize(lmHashMap *hashmap, size_t new_cap) {
+    lm_uint64 *old_hashes = hashmap->hashes;
+    void *old_slots = hashmap->slots;
+    lm_uint8 *old_ctrl = hashmap->ctrl;
+    size_t old_nbuckets = hashmap->nbuckets;
+
+    if (!_lmHashMap_alloc_table(hashmap, new_cap)) return false;
+
+    for (size_t i = 0; i < old_nbuckets; i++) {
+        if (old_ctrl[i] & 0x80) continue;
+
+        // Stored hashes mean we never need to call hash_func again
+        void *item = ((char *)old_slots) + (hashmap->elsize * i);
+        lm_uint64 hash = old_hashes[i];
+
+        size_t j = _lmHashMap_find_insert_slot(hashmap, hash);
+        _lmHashMap_set_ctrl(hashmap, j, _lmHashMap_h2(hash));
+        hashmap->hashes[j] = hash;
+        memcpy(_lmHashMap_get_slot(hashmap, j), item, hashmap->elsize);
+    }
+
+    LM_FREE(old_hashes);
+
+    _lmHashMap_update_thresholds(hashmap);
 
     return true;
 }
 
+/**
+ * @brief Make room for additional new items without growing in between.
+ */
+static inline bool _lmHashMap_ensure(lmHashMap *hashmap, size_t additional) {
+    if (hashmap->count + hashmap->deleted + additional < hashmap->growat)
+        return true;
+
+    // Rehashing also drops the tombstones, so size for live items only
+    size_t new_cap = _lmHashMap_buckets_for(hashmap, hashmap->count + additional);
+    if (new_cap < hashmap->nbuckets) new_cap = hashmap->nbuckets;
+
+    return _lmHashMap_resize(hashmap, new_cap);
+}
+
+/**
+ * @brief Insert or replace an item whose hash is already computed.
+ * 
+ * There must be room for one more item.
+ */
+static inline void *_lmHashMap_insert(lmHashMap *hashmap, void *item, lm_uint64 hash) {
+    size_t index = _lmHashMap_find(hashmap, item, hash);
+    if (index != (size_t)-1) {
+        void *slot = _lmHashMap_get_slot(hashmap, index);
+        memcpy(hashmap->spare, slot, hashmap->elsize);
+        memcpy(slot, item, hashmap->elsize);
+        return hashmap->spare;
+    }
+
+    index = _lmHashMap_find_insert_slot(hashmap, hash);
+    if (hashmap->ctrl[index] == LM_HASHMAP_CTRL_DELETED) hashmap->deleted--;
+
+    _lmHashMap_set_ctrl(hashmap, index, _lmHashMap_h2(hash));
+    hashmap->hashes[index] = hash;
+    memcpy(_lmHashMap_get_slot(hashmap, index), item, hashmap->elsize);
+    hashmap->count++;
+
+    return NULL;
+}
+
 
 lmHashMap *lmHashMap_new(
     size_t item_size,
     size_t cap,
-    lm_uint64 (*hash_func)(void *item)
+    lm_uint64 (*hash_func)(void *item),
+    int (*compare_func)(void *a, void *b)
 ) {
     // Capacity must be a power of 2 and higher than the default value.
     size_t ncap = 16;
@@ -94,201 +298,233 @@ lmHashMap *lmHashMap_new(
         cap = ncap;
     }
 
-    size_t bucketsz = sizeof(lmHashMapBucket) + item_size;
-    while (bucketsz & (sizeof(uintptr_t) - 1)) {
-        bucketsz++;
-    }
-
-    size_t size = sizeof(lmHashMap)+bucketsz*2;
-    lmHashMap *hashmap = malloc(size);
+    lmHashMap *hashmap = LM_MALLOC(sizeof(lmHashMap) + item_size);
     if (!hashmap) return NULL;
 
     hashmap->count = 0;
     hashmap->oom = false;
     hashmap->elsize = item_size;
     hashmap->hash_func = hash_func;
-    hashmap->bucketsz = bucketsz;
+    hashmap->compare_func = compare_func;
     hashmap->spare = ((char*)hashmap) + sizeof(lmHashMap);
-    hashmap->edata = (char*)hashmap->spare + bucketsz;
     hashmap->cap = cap;
-    hashmap->nbuckets = cap;
-    hashmap->mask = hashmap->nbuckets - 1;
+    hashmap->max_load = LM_HASHMAP_MAX_LOAD;
+    hashmap->min_load = LM_HASHMAP_MIN_LOAD;
 
-    hashmap->buckets = malloc(hashmap->bucketsz * hashmap->nbuckets);
-    if (!hashmap->buckets) {
-        free(hashmap);
+    if (!_lmHashMap_alloc_table(hashmap, cap)) {
+        LM_FREE(hashmap);
         return NULL;
     }
-    memset(hashmap->buckets, 0, hashmap->bucketsz * hashmap->nbuckets);
 
     hashmap->growpower = 1;
-    hashmap->growat = (size_t)(hashmap->nbuckets * 0.6);
-    hashmap->shrinkat = (size_t)(hashmap->nbuckets * 0.1);
+    _lmHashMap_update_thresholds(hashmap);
 
     return hashmap;
 }
 
 void lmHashMap_free(lmHashMap *hashmap) {
-    free(hashmap->buckets);
-    free(hashmap);
+    LM_FREE(hashmap->hashes);
+    LM_FREE(hashmap);
 }
 
 void lmHashMap_clear(lmHashMap *hashmap) {
     hashmap->count = 0;
     if (hashmap->nbuckets != hashmap->cap) {
-        void *new_buckets = malloc(hashmap->bucketsz*hashmap->cap);
-        if (new_buckets) {
-            free(hashmap->buckets);
-            hashmap->buckets = new_buckets;
+        void *old_hashes = hashmap->hashes;
+        if (_lmHashMap_alloc_table(hashmap, hashmap->cap)) {
+            LM_FREE(old_hashes);
         }
-        hashmap->nbuckets = hashmap->cap;
     }
 
-    memset(hashmap->buckets, 0, hashmap->bucketsz*hashmap->nbuckets);
-    hashmap->mask = hashmap->nbuckets - 1;
-    hashmap->growat = (size_t)(hashmap->nbuckets * 0.75); // Why does growing factor change?
-    hashmap->shrinkat = (size_t)(hashmap->nbuckets * 0.1);
+    memset(hashmap->ctrl, LM_HASHMAP_CTRL_EMPTY, hashmap->nbuckets + LM_HASHMAP_GROUP_WIDTH);
+    hashmap->deleted = 0;
+    _lmHashMap_update_thresholds(hashmap);
 }
 
 void *lmHashMap_set(lmHashMap *hashmap, void *item) {
     if (!hashmap->hash_func)
         return NULL;
 
-    lm_uint64 hash = _lmHashMap_clip(hashmap->hash_func(item));
-    hash = _lmHashMap_clip(hash);
+    lm_uint64 hash = lm_u64mix(hashmap->hash_func(item));
 
-    // Does adding one more entry overflow memory?
     hashmap->oom = false;
-    if (hashmap->count == hashmap->growat) {
-        if (!_lmHashMap_resize(hashmap, hashmap->nbuckets*(1<<hashmap->growpower))) {
+
+    // Replacing needs no room, so only grow when the key is new
+    if (hashmap->count + hashmap->deleted >= hashmap->growat &&
+        _lmHashMap_find(hashmap, item, hash) == (size_t)-1
+    ) {
+        // If most of the used slots are tombstones, rehashing at the same
+        // size is enough to clean them up.
+        size_t new_cap = hashmap->nbuckets;
+        if (hashmap->count >= hashmap->growat / 2)
+            new_cap = hashmap->nbuckets * (1 << hashmap->growpower);
+
+        if (!_lmHashMap_resize(hashmap, new_cap)) {
             hashmap->oom = true;
             return NULL;
         }
     }
 
-    lmHashMapBucket *entry = hashmap->edata;
-    entry->hash = hash;
-    entry->dib = 1;
-    void *eitem = _lmHashMap_get_bucket_item(entry);
-    memcpy(eitem, item, hashmap->elsize);
+    return _lmHashMap_insert(hashmap, item, hash);
+}
 
-    void *bitem;
-    size_t i = entry->hash & hashmap->mask;
-    while (true) {
-        lmHashMapBucket *bucket = _lmHashMap_get_bucket_at(hashmap, i);
+typedef struct {
+    size_t pos;
+    size_t index;
+} _lmHashMapBulkEntry;
+
+static int _lmHashMap_bulk_compare(const void *a, const void *b) {
+    const _lmHashMapBulkEntry *ea = (const _lmHashMapBulkEntry *)a;
+    const _lmHashMapBulkEntry *eb = (const _lmHashMapBulkEntry *)b;
+    // Ties keep input order, so with duplicate keys the later one still wins
+    if (ea->pos != eb->pos) return (ea->pos > eb->pos) - (ea->pos < eb->pos);
+    return (ea->index > eb->index) - (ea->index < eb->index);
+}
 
-        if (bucket->dib == 0) {
-            memcpy(bucket, entry, hashmap->bucketsz);
-            hashmap->count++;
-            return NULL;
-        }
+bool lmHashMap_set_many(lmHashMap *hashmap, void *items, size_t count) {
+    if (!hashmap->hash_func)
+        return false;
 
-        bitem = _lmHashMap_get_bucket_item(bucket);
+    hashmap->oom = false;
 
-        if (entry->hash == bucket->hash) {
-            memcpy(hashmap->spare, bitem, hashmap->elsize);
-            memcpy(bitem, eitem, hashmap->elsize);
-            return hashmap->spare;
-        }
+    if (!_lmHashMap_ensure(hashmap, count)) {
+        hashmap->oom = true;
+        return false;
+    }
 
-        if (bucket->dib < entry->dib) {
-            memcpy(hashmap->spare, bucket, hashmap->bucketsz);
-            memcpy(bucket, entry, hashmap->bucketsz);
-            memcpy(entry, hashmap->spare, hashmap->bucketsz);
-            eitem = _lmHashMap_get_bucket_item(entry);
-        }
+    lm_uint64 *hashes = LM_MALLOC(sizeof(lm_uint64) * count);
+    _lmHashMapBulkEntry *order = LM_MALLOC(sizeof(_lmHashMapBulkEntry) * count);
+    if (!hashes || !order) {
+        LM_FREE(hashes);
+        LM_FREE(order);
+        hashmap->oom = true;
+        return false;
+    }
 
-        i = (i + 1) & hashmap->mask;
-        entry->dib += 1;
+    for (size_t i = 0; i < count; i++) {
+        hashes[i] = lm_u64mix(hashmap->hash_func((char *)items + hashmap->elsize * i));
+        order[i] = (_lmHashMapBulkEntry){_lmHashMap_h1(hashes[i]) & hashmap->mask, i};
     }
+
+    // Insert in home slot order so the table is walked front to back
+    // instead of at random.
+    qsort(order, count, sizeof(_lmHashMapBulkEntry), _lmHashMap_bulk_compare);
+
+    for (size_t i = 0; i < count; i++) {
+        size_t index = order[i].index;
+        _lmHashMap_insert(hashmap, (char *)items + hashmap->elsize * index, hashes[index]);
+    }
+
+    LM_FREE(hashes);
+    LM_FREE(order);
+
+    return true;
 }
 
-void *lmHashMap_get(lmHashMap *hashmap, void *key) {
-    if (!hashmap->hash_func)
-        return NULL;
+bool lmHashMap_reserve(lmHashMap *hashmap, size_t count) {
+    hashmap->oom = false;
 
-    lm_uint64 hash = _lmHashMap_clip(hashmap->hash_func(key));
-    hash = _lmHashMap_clip(hash);
+    if (count <= hashmap->count) return true;
 
-    size_t i = hash & hashmap->mask;
-    while (true) {
-        lmHashMapBucket *bucket = _lmHashMap_get_bucket_at(hashmap, i);
+    if (!_lmHashMap_ensure(hashmap, count - hashmap->count)) {
+        hashmap->oom = true;
+        return false;
+    }
 
-        if (!bucket->dib) {
-            return NULL;
-        }
+    return true;
+}
 
-        if (bucket->hash == hash) {
-            void *bitem = _lmHashMap_get_bucket_item(bucket);
-            if (bitem != NULL) {
-                return bitem;
-            }
-        }
+bool lmHashMap_shrink_to_fit(lmHashMap *hashmap) {
+    hashmap->oom = false;
+
+    size_t new_cap = _lmHashMap_buckets_for(hashmap, hashmap->count);
+    if (new_cap == hashmap->nbuckets && hashmap->deleted == 0) return true;
 
-        i = (i + 1) & hashmap->mask;
+    if (!_lmHashMap_resize(hashmap, new_cap)) {
+        hashmap->oom = true;
+        return false;
     }
+
+    return true;
 }
 
-void *lmHashMap_remove(lmHashMap *hashmap, void *key) {
+void lmHashMap_set_load_factors(lmHashMap *hashmap, double max_load, double min_load) {
+    // At least one empty slot has to be left for probes to terminate, and
+    // shrinking must not land the table right back above the max load.
+    if (max_load < 0.25) max_load = 0.25;
+    if (max_load > 0.875) max_load = 0.875;
+    if (min_load < 0.0) min_load = 0.0;
+    if (min_load > max_load / 4.0) min_load = max_load / 4.0;
+
+    hashmap->max_load = max_load;
+    hashmap->min_load = min_load;
+    _lmHashMap_update_thresholds(hashmap);
+
+    // Lowering the max load may leave the table over it already. It's OK
+    // if this fails, the next set will try again.
+    _lmHashMap_ensure(hashmap, 0);
+}
+
+void *lmHashMap_get(lmHashMap *hashmap, void *key) {
     if (!hashmap->hash_func)
         return NULL;
 
-    lm_uint64 hash = _lmHashMap_clip(hashmap->hash_func(key));
-    hash = _lmHashMap_clip(hash);
+    lm_uint64 hash = lm_u64mix(hashmap->hash_func(key));
+    size_t index = _lmHashMap_find(hashmap, key, hash);
+    if (index == (size_t)-1) return NULL;
+
+    return _lmHashMap_get_slot(hashmap, index);
+}
+
+void *lmHashMap_remove(lmHashMap *hashmap, void *key) {
+    if (!hashmap->hash_func)
+        return NULL;
 
     hashmap->oom = false;
-    size_t i = hash & hashmap->mask;
-    
-    while (true) {
-        lmHashMapBucket *bucket = _lmHashMap_get_bucket_at(hashmap, i);
-        if (!bucket->dib) {
-            return NULL;
-        }
 
-        void *bitem = _lmHashMap_get_bucket_item(bucket);
-        if (bucket->hash == hash) {
-            memcpy(hashmap->spare, bitem, hashmap->elsize);
-            bucket->dib = 0;
-            while (true) {
-                lmHashMapBucket *prev = bucket;
-                i = (i + 1) & hashmap->mask;
-                
-                bucket = _lmHashMap_get_bucket_at(hashmap, i);
-                if (bucket->dib <= 1) {
-                    prev->dib = 0;
-                    break;
-                }
-
-                memcpy(prev, bucket, hashmap->bucketsz);
-                prev->dib--;
-            }
+    lm_uint64 hash = lm_u64mix(hashmap->hash_func(key));
+    size_t index = _lmHashMap_find(hashmap, key, hash);
+    if (index == (size_t)-1) return NULL;
 
-            hashmap->count--;
+    memcpy(hashmap->spare, _lmHashMap_get_slot(hashmap, index), hashmap->elsize);
 
-            if (hashmap->nbuckets > hashmap->cap && hashmap->count <= hashmap->shrinkat) {
-                // It's OK for the _lmHashMap_resize operation to fail to allocate enough
-                // memory because shriking does not change the integrity of the data.
-                _lmHashMap_resize(hashmap, hashmap->nbuckets / 2);
-            }
+    // If no probe sequence could have passed over this slot while it was
+    // full, it can go back to empty instead of leaving a tombstone.
+    size_t index_before = (index - LM_HASHMAP_GROUP_WIDTH) & hashmap->mask;
+    _lmBitMask empty_after = _lmGroup_match_empty(hashmap->ctrl + index);
+    _lmBitMask empty_before = _lmGroup_match_empty(hashmap->ctrl + index_before);
 
-            return hashmap->spare;
-        }
+    bool was_never_full = empty_before && empty_after &&
+        (__builtin_ctz(empty_after) + __builtin_clz(empty_before << 16)) < LM_HASHMAP_GROUP_WIDTH;
 
-        i = (i + 1) & hashmap->mask;
+    if (was_never_full) {
+        _lmHashMap_set_ctrl(hashmap, index, LM_HASHMAP_CTRL_EMPTY);
     }
+    else {
+        _lmHashMap_set_ctrl(hashmap, index, LM_HASHMAP_CTRL_DELETED);
+        hashmap->deleted++;
+    }
+
+    hashmap->count--;
+
+    if (hashmap->nbuckets > hashmap->cap && hashmap->count <= hashmap->shrinkat) {
+        // It's OK for the _lmHashMap_resize operation to fail to allocate enough
+        // memory because shriking does not change the integrity of the data.
+        _lmHashMap_resize(hashmap, hashmap->nbuckets / 2);
+    }
+
+    return hashmap->spare;
 }
 
 bool lmHashMap_iter(lmHashMap *hashmap, size_t *index, void **item) {
-    lmHashMapBucket *bucket;
-    do {
-        if (*index >= hashmap->nbuckets) {
-            return false;
+    while (*index < hashmap->nbuckets) {
+        size_t i = (*index)++;
+
+        if (!(hashmap->ctrl[i] & 0x80)) {
+            *item = _lmHashMap_get_slot(hashmap, i);
+            return true;
         }
-        bucket = _lmHashMap_get_bucket_at(hashmap, *index);
-        (*index)++;
-    } while (!bucket->dib);
+    }
 
-    *item = _lmHashMap_get_bucket_item(bucket);
-    
-    return true;
+    return false;
 }
\ No newline at end of file
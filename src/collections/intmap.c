@@ -0,0 +1,201 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_COLLECTIONS
+
+#include "lumina/collections/intmap.h"
+
+
+/**
+ * @file collections/intmap.c
+ * 
+ * @brief Integer-keyed flat hash map.
+ */
+
+
+static inline bool _lmIntMap_alloc(lmIntMap *map, size_t cap) {
+    // Keys and values in one block, keys first
+    lm_uint64 *keys = LM_MALLOC(sizeof(lm_uint64) * cap * 2);
+    if (!keys) return false;
+
+    // All bits set is LM_INTMAP_EMPTY_KEY
+    memset(keys, 0xFF, sizeof(lm_uint64) * cap);
+
+    map->keys = keys;
+    map->values = keys + cap;
+    map->cap = cap;
+    map->mask = cap - 1;
+    map->growat = cap / 2 + cap / 4;
+
+    return true;
+}
+
+static inline void _lmIntMap_insert(lmIntMap *map, lm_uint64 key, lm_uint64 value) {
+    size_t i = lm_u64mix(key) & map->mask;
+    while (map->keys[i] != LM_INTMAP_EMPTY_KEY)
+        i = (i + 1) & map->mask;
+
+    map->keys[i] = key;
+    map->values[i] = value;
+}
+
+static inline bool _lmIntMap_resize(lmIntMap *map, size_t new_cap) {
+    lm_uint64 *old_keys = map->keys;
+    lm_uint64 *old_values = map->values;
+    size_t old_cap = map->cap;
+
+    if (!_lmIntMap_alloc(map, new_cap)) return false;
+
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old_keys[i] != LM_INTMAP_EMPTY_KEY)
+            _lmIntMap_insert(map, old_keys[i], old_values[i]);
+    }
+
+    LM_FREE(old_keys);
+
+    return true;
+}
+
+
+lmIntMap *lmIntMap_new(size_t cap) {
+    // Capacity must be a power of 2 and higher than the default value.
+    size_t ncap = 16;
+    while (ncap < cap) ncap *= 2;
+
+    lmIntMap *map = LM_NEW(lmIntMap);
+    if (!map) return NULL;
+
+    if (!_lmIntMap_alloc(map, ncap)) {
+        LM_FREE(map);
+        return NULL;
+    }
+
+    map->count = 0;
+    map->oom = false;
+    map->has_empty_key = false;
+    map->empty_key_value = 0;
+
+    return map;
+}
+
+void lmIntMap_free(lmIntMap *map) {
+    LM_FREE(map->keys);
+    LM_FREE(map);
+}
+
+void lmIntMap_clear(lmIntMap *map) {
+    memset(map->keys, 0xFF, sizeof(lm_uint64) * map->cap);
+    map->count = 0;
+    map->has_empty_key = false;
+}
+
+bool lmIntMap_set(lmIntMap *map, lm_uint64 key, lm_uint64 value) {
+    map->oom = false;
+
+    if (key == LM_INTMAP_EMPTY_KEY) {
+        if (!map->has_empty_key) map->count++;
+        map->has_empty_key = true;
+        map->empty_key_value = value;
+        return true;
+    }
+
+    size_t i = lm_u64mix(key) & map->mask;
+    while (true) {
+        lm_uint64 k = map->keys[i];
+
+        if (k == key) {
+            map->values[i] = value;
+            return true;
+        }
+
+        if (k == LM_INTMAP_EMPTY_KEY) break;
+
+        i = (i + 1) & map->mask;
+    }
+
+    if (map->count >= map->growat) {
+        if (!_lmIntMap_resize(map, map->cap * 2)) {
+            map->oom = true;
+            return false;
+        }
+
+        _lmIntMap_insert(map, key, value);
+    }
+    else {
+        map->keys[i] = key;
+        map->values[i] = value;
+    }
+
+    map->count++;
+
+    return true;
+}
+
+bool lmIntMap_remove(lmIntMap *map, lm_uint64 key, lm_uint64 *value) {
+    if (key == LM_INTMAP_EMPTY_KEY) {
+        if (!map->has_empty_key) return false;
+        if (value) *value = map->empty_key_value;
+        map->has_empty_key = false;
+        map->count--;
+        return true;
+    }
+
+    size_t i = lm_u64mix(key) & map->mask;
+    while (map->keys[i] != key) {
+        if (map->keys[i] == LM_INTMAP_EMPTY_KEY) return false;
+        i = (i + 1) & map->mask;
+    }
+
+    if (value) *value = map->values[i];
+
+    // Shift following entries of the cluster back into the hole, so probe
+    // sequences stay unbroken without tombstones.
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & map->mask;
+        lm_uint64 k = map->keys[j];
+        if (k == LM_INTMAP_EMPTY_KEY) break;
+
+        // Entry at j can move to i only if its home slot is not in (i, j]
+        size_t home = lm_u64mix(k) & map->mask;
+        if (((j - home) & map->mask) >= ((j - i) & map->mask)) {
+            map->keys[i] = k;
+            map->values[i] = map->values[j];
+            i = j;
+        }
+    }
+
+    map->keys[i] = LM_INTMAP_EMPTY_KEY;
+    map->count--;
+
+    return true;
+}
+
+bool lmIntMap_iter(lmIntMap *map, size_t *index, lm_uint64 *key, lm_uint64 *value) {
+    while (*index < map->cap) {
+        size_t i = (*index)++;
+
+        if (map->keys[i] != LM_INTMAP_EMPTY_KEY) {
+            *key = map->keys[i];
+            *value = map->values[i];
+            return true;
+        }
+    }
+
+    // The empty key lives outside the table, yield it last
+    if (*index == map->cap && map->has_empty_key) {
+        (*index)++;
+        *key = LM_INTMAP_EMPTY_KEY;
+        *value = map->empty_key_value;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,200 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_COLLECTIONS
+
+#include "lumina/collections/queue.h"
+
+
+/**
+ * @file collections/queue.c
+ * 
+ * @brief Bounded lock-free queues for passing data between threads.
+ */
+
+
+static inline size_t _lm_queue_capacity(size_t cap) {
+    size_t ncap = 2;
+    while (ncap < cap) ncap *= 2;
+    return ncap;
+}
+
+
+lmSPSCQueue *lmSPSCQueue_new(size_t elsize, size_t cap) {
+    lmSPSCQueue *queue = LM_NEW(lmSPSCQueue);
+    if (!queue) return NULL;
+
+    queue->elsize = elsize;
+    queue->cap = _lm_queue_capacity(cap);
+    queue->mask = queue->cap - 1;
+    queue->buffer = LM_MALLOC(elsize * queue->cap);
+    if (!queue->buffer) {
+        LM_FREE(queue);
+        return NULL;
+    }
+
+    queue->head = 0;
+    queue->cached_tail = 0;
+    queue->tail = 0;
+    queue->cached_head = 0;
+
+    return queue;
+}
+
+void lmSPSCQueue_free(lmSPSCQueue *queue) {
+    LM_FREE(queue->buffer);
+    LM_FREE(queue);
+}
+
+bool lmSPSCQueue_push(lmSPSCQueue *queue, const void *elem) {
+    // Only the producer writes tail
+    size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+
+    if (tail - queue->cached_head == queue->cap) {
+        queue->cached_head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+        if (tail - queue->cached_head == queue->cap) return false;
+    }
+
+    memcpy(queue->buffer + queue->elsize * (tail & queue->mask), elem, queue->elsize);
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+bool lmSPSCQueue_pop(lmSPSCQueue *queue, void *elem) {
+    // Only the consumer writes head
+    size_t head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+
+    if (head == queue->cached_tail) {
+        queue->cached_tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+        if (head == queue->cached_tail) return false;
+    }
+
+    memcpy(elem, queue->buffer + queue->elsize * (head & queue->mask), queue->elsize);
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+size_t lmSPSCQueue_size(lmSPSCQueue *queue) {
+    size_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    size_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    return tail - head;
+}
+
+
+/*
+    A cell is its sequence number followed by the element, padded so the
+    next cell's sequence stays aligned.
+*/
+
+static inline size_t *_lmMPMCQueue_sequence(lmMPMCQueue *queue, size_t pos) {
+    return (size_t *)(queue->cells + queue->stride * (pos & queue->mask));
+}
+
+static inline void *_lmMPMCQueue_data(size_t *sequence) {
+    return (char *)sequence + sizeof(max_align_t);
+}
+
+
+lmMPMCQueue *lmMPMCQueue_new(size_t elsize, size_t cap) {
+    lmMPMCQueue *queue = LM_NEW(lmMPMCQueue);
+    if (!queue) return NULL;
+
+    size_t align = sizeof(max_align_t);
+
+    queue->elsize = elsize;
+    queue->stride = align + (elsize + align - 1) / align * align;
+    queue->cap = _lm_queue_capacity(cap);
+    queue->mask = queue->cap - 1;
+    queue->cells = LM_MALLOC(queue->stride * queue->cap);
+    if (!queue->cells) {
+        LM_FREE(queue);
+        return NULL;
+    }
+
+    // Cell i is free for the producer at position i
+    for (size_t i = 0; i < queue->cap; i++)
+        *_lmMPMCQueue_sequence(queue, i) = i;
+
+    queue->enqueue_pos = 0;
+    queue->dequeue_pos = 0;
+
+    return queue;
+}
+
+void lmMPMCQueue_free(lmMPMCQueue *queue) {
+    LM_FREE(queue->cells);
+    LM_FREE(queue);
+}
+
+bool lmMPMCQueue_push(lmMPMCQueue *queue, const void *elem) {
+    size_t pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+    size_t *sequence;
+
+    while (true) {
+        sequence = _lmMPMCQueue_sequence(queue, pos);
+        size_t seq = __atomic_load_n(sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if (diff == 0) {
+            // Cell is free, try to claim the position. On failure pos is
+            // updated to the current one.
+            if (__atomic_compare_exchange_n(
+                &queue->enqueue_pos, &pos, pos + 1, true,
+                __ATOMIC_RELAXED, __ATOMIC_RELAXED
+            )) break;
+        }
+        else if (diff < 0) {
+            // Cell still holds an element from the previous lap
+            return false;
+        }
+        else {
+            pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(_lmMPMCQueue_data(sequence), elem, queue->elsize);
+    __atomic_store_n(sequence, pos + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+bool lmMPMCQueue_pop(lmMPMCQueue *queue, void *elem) {
+    size_t pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+    size_t *sequence;
+
+    while (true) {
+        sequence = _lmMPMCQueue_sequence(queue, pos);
+        size_t seq = __atomic_load_n(sequence, __ATOMIC_ACQUIRE);
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(
+                &queue->dequeue_pos, &pos, pos + 1, true,
+                __ATOMIC_RELAXED, __ATOMIC_RELAXED
+            )) break;
+        }
+        else if (diff < 0) {
+            // Cell has not been filled yet
+            return false;
+        }
+        else {
+            pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(elem, _lmMPMCQueue_data(sequence), queue->elsize);
+
+    // Free the cell for the producer one lap ahead
+    __atomic_store_n(sequence, pos + queue->mask + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
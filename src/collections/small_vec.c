@@ -0,0 +1,51 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_COLLECTIONS
+
+#include "lumina/collections/small_vec.h"
+
+
+/**
+ * @file collections/small_vec.c
+ * 
+ * @brief Dynamically growing array with inline storage for short lists.
+ */
+
+
+bool _lm_small_vec_grow(
+    void *storage,
+    lm_uint32 size,
+    lm_uint32 *max,
+    size_t elsize,
+    size_t inline_cap
+) {
+    lm_uint32 new_max = *max * 2;
+
+    if (*max <= inline_cap) {
+        // Spill the inline elements to the heap. The heap pointer shares
+        // storage with them, so copy before writing it.
+        void *heap = LM_MALLOC(elsize * new_max);
+        if (!heap) return false;
+
+        memcpy(heap, storage, elsize * size);
+        *(void **)storage = heap;
+    }
+    else {
+        void *heap = LM_REALLOC(*(void **)storage, elsize * new_max);
+        if (!heap) return false;
+
+        *(void **)storage = heap;
+    }
+
+    *max = new_max;
+
+    return true;
+}
@@ -0,0 +1,131 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_COLLECTIONS
+
+#include "lumina/collections/vec.h"
+
+
+/**
+ * @file collections/vec.c
+ * 
+ * @brief Value-storing dynamically growing array implementation.
+ */
+
+
+/**
+ * @brief Largest element count whose size in bytes fits in size_t.
+ */
+static inline size_t _lmVec_max_count(lmVec *vec) {
+    return vec->elsize ? SIZE_MAX / vec->elsize : SIZE_MAX;
+}
+
+static inline bool _lmVec_grow(lmVec *vec, size_t count) {
+    if (count <= vec->max) return true;
+
+    size_t max_count = _lmVec_max_count(vec);
+    if (count > max_count) return false;
+
+    // Double the storage so appending one by one is amortized O(1),
+    // clamped so the byte size can't overflow.
+    size_t new_max = vec->max ? vec->max : 4;
+    do {
+        new_max = new_max > max_count / 2 ? max_count : new_max * 2;
+    } while (new_max < count);
+
+    void *new_data = LM_REALLOC(vec->data, vec->elsize * new_max);
+    if (!new_data) return false;
+
+    vec->data = new_data;
+    vec->max = new_max;
+
+    return true;
+}
+
+
+lmVec *lmVec_new(size_t elsize) {
+    lmVec *vec = LM_NEW(lmVec);
+    if (!vec) return NULL;
+
+    vec->elsize = elsize;
+    vec->size = 0;
+    vec->max = 0;
+    vec->data = NULL;
+
+    return vec;
+}
+
+void lmVec_free(lmVec *vec) {
+    LM_FREE(vec->data);
+    LM_FREE(vec);
+}
+
+bool lmVec_reserve(lmVec *vec, size_t count) {
+    if (count <= vec->max) return true;
+    if (count > _lmVec_max_count(vec)) return false;
+
+    // Reserve exactly, the caller knows how much it needs
+    void *new_data = LM_REALLOC(vec->data, vec->elsize * count);
+    if (!new_data) return false;
+
+    vec->data = new_data;
+    vec->max = count;
+
+    return true;
+}
+
+void *lmVec_push(lmVec *vec, const void *elem) {
+    if (!_lmVec_grow(vec, vec->size + 1)) return NULL;
+
+    void *slot = (char *)vec->data + vec->elsize * vec->size;
+    if (elem) memcpy(slot, elem, vec->elsize);
+    else memset(slot, 0, vec->elsize);
+
+    vec->size++;
+
+    return slot;
+}
+
+bool lmVec_append(lmVec *vec, const void *elems, size_t count) {
+    if (count == 0) return true;
+    if (count > SIZE_MAX - vec->size) return false;
+    if (!_lmVec_grow(vec, vec->size + count)) return false;
+
+    memcpy((char *)vec->data + vec->elsize * vec->size, elems, vec->elsize * count);
+    vec->size += count;
+
+    return true;
+}
+
+bool lmVec_pop(lmVec *vec, void *elem) {
+    if (vec->size == 0) return false;
+
+    vec->size--;
+    if (elem) memcpy(elem, (char *)vec->data + vec->elsize * vec->size, vec->elsize);
+
+    return true;
+}
+
+bool lmVec_swap_remove(lmVec *vec, size_t index, void *elem) {
+    if (index >= vec->size) return false;
+
+    char *slot = (char *)vec->data + vec->elsize * index;
+    if (elem) memcpy(elem, slot, vec->elsize);
+
+    vec->size--;
+    if (index != vec->size)
+        memcpy(slot, (char *)vec->data + vec->elsize * vec->size, vec->elsize);
+
+    return true;
+}
+
+void lmVec_clear(lmVec *vec) {
+    vec->size = 0;
+}
@@ -0,0 +1,301 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_ECS
+
+#include "lumina/components/transform_hierarchy.h"
+#include "lumina/math/fastmath.h"
+
+
+/**
+ * @file components/transform_hierarchy.c
+ * 
+ * @brief Parent-child transform relationships and world matrices.
+ */
+
+
+#define _LM_NODE(hierarchy, index) LM_VEC_AT((hierarchy)->nodes, lmTransformNode, index)
+
+
+/**
+ * @brief lmTransform_to_matrix with lm_fast_sincos, this runs for every
+ *        changed node.
+ */
+static inline lmMatrix3x2 _lm_local_matrix(lmTransform local) {
+    float s, c;
+    lm_fast_sincos(local.rotation, &s, &c);
+
+    return (lmMatrix3x2){
+        c * local.scale.x, s * local.scale.x,
+        -s * local.scale.y, c * local.scale.y,
+        local.position.x, local.position.y
+    };
+}
+
+
+/**
+ * @brief Recompute parent indices and depths, then stable sort nodes by depth.
+ * 
+ * Depth is at most the node count, so this is a counting sort and the whole
+ * rebuild is linear.
+ */
+static void _lmTransformHierarchy_rebuild(lmTransformHierarchy *hierarchy) {
+    size_t n = hierarchy->nodes->size;
+    if (n == 0) return;
+
+    for (size_t i = 0; i < n; i++) {
+        lmTransformNode *node = &_LM_NODE(hierarchy, i);
+        lm_uint64 parent_index;
+
+        if (node->parent != LM_TRANSFORM_ROOT && lmIntMap_get(hierarchy->indices, node->parent, &parent_index))
+            node->parent_index = (lm_uint32)parent_index;
+        else
+            node->parent_index = LM_TRANSFORM_NO_INDEX;
+
+        node->depth = LM_TRANSFORM_NO_INDEX;
+    }
+
+    // Walk up to the first ancestor with a known depth, then fill in the path
+    lm_uint32 max_depth = 0;
+    for (size_t i = 0; i < n; i++) {
+        lm_uint32 steps = 0;
+        lm_uint32 j = (lm_uint32)i;
+        while (j != LM_TRANSFORM_NO_INDEX && _LM_NODE(hierarchy, j).depth == LM_TRANSFORM_NO_INDEX) {
+            j = _LM_NODE(hierarchy, j).parent_index;
+            steps++;
+        }
+
+        lm_uint32 depth = (j == LM_TRANSFORM_NO_INDEX) ? steps - 1 : _LM_NODE(hierarchy, j).depth + steps;
+        if (depth > max_depth) max_depth = depth;
+
+        j = (lm_uint32)i;
+        while (steps--) {
+            _LM_NODE(hierarchy, j).depth = depth--;
+            j = _LM_NODE(hierarchy, j).parent_index;
+        }
+    }
+
+    size_t *offsets = LM_MALLOC(sizeof(size_t) * (max_depth + 1));
+    lmTransformNode *sorted = LM_MALLOC(sizeof(lmTransformNode) * n);
+    LM_MEMORY_ASSERT(offsets);
+    LM_MEMORY_ASSERT(sorted);
+
+    memset(offsets, 0, sizeof(size_t) * (max_depth + 1));
+    for (size_t i = 0; i < n; i++)
+        offsets[_LM_NODE(hierarchy, i).depth]++;
+
+    size_t total = 0;
+    for (lm_uint32 d = 0; d <= max_depth; d++) {
+        size_t count = offsets[d];
+        offsets[d] = total;
+        total += count;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        lmTransformNode *node = &_LM_NODE(hierarchy, i);
+        sorted[offsets[node->depth]++] = *node;
+    }
+
+    memcpy(hierarchy->nodes->data, sorted, sizeof(lmTransformNode) * n);
+    LM_FREE(sorted);
+    LM_FREE(offsets);
+
+    lmIntMap_clear(hierarchy->indices);
+    for (size_t i = 0; i < n; i++)
+        LM_MEMORY_ASSERT(lmIntMap_set(hierarchy->indices, _LM_NODE(hierarchy, i).entity, i));
+
+    for (size_t i = 0; i < n; i++) {
+        lmTransformNode *node = &_LM_NODE(hierarchy, i);
+        lm_uint64 parent_index;
+
+        if (node->parent != LM_TRANSFORM_ROOT && lmIntMap_get(hierarchy->indices, node->parent, &parent_index))
+            node->parent_index = (lm_uint32)parent_index;
+    }
+}
+
+
+lmTransformHierarchy *lmTransformHierarchy_new() {
+    lmTransformHierarchy *hierarchy = LM_NEW(lmTransformHierarchy);
+    LM_MEMORY_ASSERT(hierarchy);
+
+    hierarchy->nodes = lmVec_new(sizeof(lmTransformNode));
+    LM_MEMORY_ASSERT(hierarchy->nodes);
+
+    hierarchy->indices = lmIntMap_new(0);
+    LM_MEMORY_ASSERT(hierarchy->indices);
+
+    hierarchy->dirty_count = 0;
+    hierarchy->needs_rebuild = false;
+    hierarchy->has_changed = false;
+
+    return hierarchy;
+}
+
+void lmTransformHierarchy_free(lmTransformHierarchy *hierarchy) {
+    if (!hierarchy) return;
+
+    lmVec_free(hierarchy->nodes);
+    lmIntMap_free(hierarchy->indices);
+    LM_FREE(hierarchy);
+}
+
+bool lmTransformHierarchy_add(
+    lmTransformHierarchy *hierarchy,
+    lm_uint64 entity,
+    lm_uint64 parent,
+    lmTransform local
+) {
+    if (entity == LM_TRANSFORM_ROOT) return false;
+    if (lmTransformHierarchy_get(hierarchy, entity)) return false;
+
+    lmTransformNode node;
+    node.world = lmMatrix3x2_identity;
+    node.local = local;
+    node.entity = entity;
+    node.parent = parent;
+    node.parent_index = LM_TRANSFORM_NO_INDEX;
+    node.depth = 0;
+    node.dirty = true;
+    node.recomputed = false;
+    node.changed = false;
+
+    if (parent != LM_TRANSFORM_ROOT) {
+        lm_uint64 parent_index;
+        if (!lmIntMap_get(hierarchy->indices, parent, &parent_index)) return false;
+
+        // Appending keeps parents before children, no need to rebuild
+        node.parent_index = (lm_uint32)parent_index;
+        node.depth = _LM_NODE(hierarchy, parent_index).depth + 1;
+    }
+
+    size_t index = hierarchy->nodes->size;
+    LM_MEMORY_ASSERT(lmVec_push(hierarchy->nodes, &node));
+    LM_MEMORY_ASSERT(lmIntMap_set(hierarchy->indices, entity, index));
+    hierarchy->dirty_count++;
+
+    return true;
+}
+
+bool lmTransformHierarchy_remove(lmTransformHierarchy *hierarchy, lm_uint64 entity) {
+    lm_uint64 index;
+    if (!lmIntMap_remove(hierarchy->indices, entity, &index)) return false;
+
+    for (size_t i = 0; i < hierarchy->nodes->size; i++) {
+        lmTransformNode *node = &_LM_NODE(hierarchy, i);
+        if (node->parent != entity) continue;
+
+        node->parent = LM_TRANSFORM_ROOT;
+        node->dirty = true;
+        hierarchy->dirty_count++;
+    }
+
+    lmVec_swap_remove(hierarchy->nodes, index, NULL);
+    if (index < hierarchy->nodes->size)
+        LM_MEMORY_ASSERT(lmIntMap_set(hierarchy->indices, _LM_NODE(hierarchy, index).entity, index));
+
+    hierarchy->needs_rebuild = true;
+
+    return true;
+}
+
+bool lmTransformHierarchy_set_parent(
+    lmTransformHierarchy *hierarchy,
+    lm_uint64 entity,
+    lm_uint64 parent
+) {
+    lmTransformNode *node = lmTransformHierarchy_get(hierarchy, entity);
+    if (!node) return false;
+    if (node->parent == parent) return true;
+
+    // Walk by entity, indices are stale until the next rebuild
+    lm_uint64 ancestor = parent;
+    while (ancestor != LM_TRANSFORM_ROOT) {
+        if (ancestor == entity) return false;
+
+        lmTransformNode *ancestor_node = lmTransformHierarchy_get(hierarchy, ancestor);
+        if (!ancestor_node) return false;
+        ancestor = ancestor_node->parent;
+    }
+
+    node->parent = parent;
+    node->dirty = true;
+    hierarchy->dirty_count++;
+    hierarchy->needs_rebuild = true;
+
+    return true;
+}
+
+bool lmTransformHierarchy_set_local(
+    lmTransformHierarchy *hierarchy,
+    lm_uint64 entity,
+    lmTransform local
+) {
+    lmTransformNode *node = lmTransformHierarchy_get(hierarchy, entity);
+    if (!node) return false;
+
+    node->local = local;
+    if (!node->dirty) {
+        node->dirty = true;
+        hierarchy->dirty_count++;
+    }
+
+    return true;
+}
+
+lmTransformNode *lmTransformHierarchy_get(lmTransformHierarchy *hierarchy, lm_uint64 entity) {
+    lm_uint64 index;
+    if (!lmIntMap_get(hierarchy->indices, entity, &index)) return NULL;
+    return &_LM_NODE(hierarchy, index);
+}
+
+lmMatrix3x2 lmTransformHierarchy_get_world(lmTransformHierarchy *hierarchy, lm_uint64 entity) {
+    lmTransformNode *node = lmTransformHierarchy_get(hierarchy, entity);
+    if (!node) return lmMatrix3x2_identity;
+    return node->world;
+}
+
+void lmTransformHierarchy_begin_frame(lmTransformHierarchy *hierarchy) {
+    if (!hierarchy->has_changed) return;
+
+    for (size_t i = 0; i < hierarchy->nodes->size; i++)
+        _LM_NODE(hierarchy, i).changed = false;
+    hierarchy->has_changed = false;
+}
+
+void lmTransformHierarchy_update(lmTransformHierarchy *hierarchy) {
+    if (hierarchy->dirty_count == 0 && !hierarchy->needs_rebuild) return;
+
+    if (hierarchy->needs_rebuild) {
+        _lmTransformHierarchy_rebuild(hierarchy);
+        hierarchy->needs_rebuild = false;
+    }
+
+    // Parents come first, so a node's parent is always final when it's reached
+    lmTransformNode *nodes = hierarchy->nodes->data;
+    for (size_t i = 0; i < hierarchy->nodes->size; i++) {
+        lmTransformNode *node = &nodes[i];
+        lm_uint32 parent_index = node->parent_index;
+
+        node->recomputed = node->dirty || (parent_index != LM_TRANSFORM_NO_INDEX && nodes[parent_index].recomputed);
+        if (!node->recomputed) continue;
+
+        lmMatrix3x2 local = _lm_local_matrix(node->local);
+        if (parent_index == LM_TRANSFORM_NO_INDEX)
+            node->world = local;
+        else
+            node->world = lmMatrix3x2_mul(nodes[parent_index].world, local);
+
+        node->dirty = false;
+        node->changed = true;
+    }
+
+    hierarchy->dirty_count = 0;
+    hierarchy->has_changed = true;
+}
@@ -0,0 +1,124 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_CORE
+
+#include "lumina/core/arena.h"
+
+
+/**
+ * @file core/arena.c
+ * 
+ * @brief Per-frame linear (bump) allocator.
+ */
+
+
+#define _LM_ARENA_ALIGNMENT (sizeof(max_align_t))
+
+struct _lmFrameArenaBlock {
+    _lmFrameArenaBlock *next;
+    max_align_t data[];
+};
+
+
+static inline size_t _lm_align_up(size_t size) {
+    return (size + (_LM_ARENA_ALIGNMENT - 1)) & ~(_LM_ARENA_ALIGNMENT - 1);
+}
+
+static void _lmFrameArena_release_overflow(lmFrameArenaBuffer *buffer) {
+    _lmFrameArenaBlock *block = buffer->overflow;
+    while (block) {
+        _lmFrameArenaBlock *next = block->next;
+        LM_FREE(block);
+        block = next;
+    }
+
+    buffer->overflow = NULL;
+}
+
+
+lmFrameArena *lmFrameArena_new(size_t capacity) {
+    lmFrameArena *arena = LM_NEW(lmFrameArena);
+    LM_MEMORY_ASSERT(arena);
+
+    capacity = _lm_align_up(capacity);
+
+    for (size_t i = 0; i < 2; i++) {
+        lmFrameArenaBuffer *buffer = &arena->buffers[i];
+
+        buffer->data = LM_MALLOC(capacity);
+        LM_MEMORY_ASSERT(buffer->data);
+        buffer->capacity = capacity;
+        buffer->offset = 0;
+        buffer->requested = 0;
+        buffer->overflow = NULL;
+    }
+
+    arena->index = 0;
+    arena->peak = 0;
+
+    return arena;
+}
+
+void lmFrameArena_free(lmFrameArena *arena) {
+    if (!arena) return;
+
+    for (size_t i = 0; i < 2; i++) {
+        _lmFrameArena_release_overflow(&arena->buffers[i]);
+        LM_FREE(arena->buffers[i].data);
+    }
+
+    LM_FREE(arena);
+}
+
+void lmFrameArena_reset(lmFrameArena *arena) {
+    arena->index ^= 1;
+    lmFrameArenaBuffer *buffer = &arena->buffers[arena->index];
+
+    _lmFrameArena_release_overflow(buffer);
+
+    // The last time this half was used it didn't fit, grow it once so the
+    // following frames don't overflow again.
+    if (buffer->requested > buffer->capacity) {
+        size_t capacity = _lm_align_up(buffer->requested + buffer->requested / 2);
+        lm_uint8 *data = LM_MALLOC(capacity);
+
+        if (data) {
+            LM_FREE(buffer->data);
+            buffer->data = data;
+            buffer->capacity = capacity;
+        }
+    }
+
+    buffer->offset = 0;
+    buffer->requested = 0;
+}
+
+void *lmFrameArena_alloc(lmFrameArena *arena, size_t size) {
+    lmFrameArenaBuffer *buffer = &arena->buffers[arena->index];
+
+    size = _lm_align_up(size);
+    buffer->requested += size;
+    if (buffer->requested > arena->peak) arena->peak = buffer->requested;
+
+    if (buffer->offset + size <= buffer->capacity) {
+        void *ptr = buffer->data + buffer->offset;
+        buffer->offset += size;
+        return ptr;
+    }
+
+    _lmFrameArenaBlock *block = LM_MALLOC(sizeof(_lmFrameArenaBlock) + size);
+    if (!block) return NULL;
+
+    block->next = buffer->overflow;
+    buffer->overflow = block;
+
+    return block->data;
+}
@@ -8,6 +8,8 @@
 
 */
 
+#define LM_MEMORY_TAG lmMemoryTag_CORE
+
 #include "lumina/core/clock.h"
 #include "lumina/core/constants.h"
 
@@ -19,6 +21,42 @@
  */
 
 
+static int _lm_compare_double(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void _lmClock_wait_precise(lmClock *clock, double target_fps) {
+    lm_uint64 period = (lm_uint64)(clock->frequency / target_fps);
+    lm_uint64 now = SDL_GetPerformanceCounter();
+
+    // Deadlines are advanced by whole periods from the previous deadline
+    // instead of the current time, so rounding errors don't accumulate.
+    // If we fell behind by more than a frame, resynchronize instead of
+    // rushing through the missed frames.
+    if (clock->deadline == 0 || now > clock->deadline + period)
+        clock->deadline = now + period;
+    else
+        clock->deadline += period;
+
+    if (now >= clock->deadline) return;
+
+    double remaining = (double)(clock->deadline - now) / clock->frequency * 1000.0;
+    if (remaining > LM_CLOCK_SPIN_THRESHOLD) {
+        SDL_Delay((lm_uint32)(remaining - LM_CLOCK_SPIN_THRESHOLD));
+    }
+
+    while (SDL_GetPerformanceCounter() < clock->deadline);
+}
+
+static void _lmClock_update_percentiles(lmClock *clock) {
+    clock->frame_time_p50 = lmClock_get_frame_time_percentile(clock, 50.0);
+    clock->frame_time_p95 = lmClock_get_frame_time_percentile(clock, 95.0);
+    clock->frame_time_p99 = lmClock_get_frame_time_percentile(clock, 99.0);
+}
+
+
 lmClock *lmClock_new() {
     lmClock *clock = LM_NEW(lmClock);
     LM_MEMORY_ASSERT(clock);
@@ -35,13 +73,22 @@ lmClock *lmClock_new() {
     clock->timer_full_end = 0;
     clock->fps_counter = 0;
 
+    clock->pacing = lmClockPacing_SLEEP;
+    clock->deadline = 0;
+
+    clock->frame_times_index = 0;
+    clock->frame_times_count = 0;
+    clock->frame_time_p50 = 0.0;
+    clock->frame_time_p95 = 0.0;
+    clock->frame_time_p99 = 0.0;
+
     return clock;
 }
 
 void lmClock_free(lmClock *clock) {
     if (!clock) return;
 
-    free(clock);
+    LM_FREE(clock);
 }
 
 void lmClock_tick(lmClock *clock, double target_fps) {
@@ -58,18 +105,51 @@ void lmClock_tick(lmClock *clock, double target_fps) {
 
         clock->fps_counter = 0;
         clock->accumulated_fps = 0.0;
+
+        _lmClock_update_percentiles(clock);
     }
 
-    double target_wait_time = 1000.0 / target_fps;
-    if (frame_time < target_wait_time) {
-        SDL_Delay((lm_uint32)(target_wait_time - frame_time));
+    if (target_fps > 0.0) {
+        if (clock->pacing == lmClockPacing_PRECISE) {
+            _lmClock_wait_precise(clock, target_fps);
+        }
+        else {
+            double target_wait_time = 1000.0 / target_fps;
+            if (frame_time < target_wait_time) {
+                SDL_Delay((lm_uint32)(target_wait_time - frame_time));
+            }
+        }
     }
 
     clock->timer_full_end = SDL_GetPerformanceCounter();
     clock->frame_time_full = ((double)clock->timer_full_end / clock->frequency - start) * 1000.0;
     clock->dt = clock->frame_time_full / 1000.0;
 
+    // The very first tick has no previous frame to measure against
+    if (clock->timer_start != 0) {
+        clock->frame_times[clock->frame_times_index] = clock->frame_time_full;
+        clock->frame_times_index = (clock->frame_times_index + 1) % LM_FRAME_TIME_HISTORY;
+        if (clock->frame_times_count < LM_FRAME_TIME_HISTORY)
+            clock->frame_times_count++;
+    }
+
     clock->timer_start = SDL_GetPerformanceCounter();
 
     clock->time = (double)SDL_GetPerformanceCounter() / clock->frequency - clock->start;
+}
+
+double lmClock_get_frame_time_percentile(lmClock *clock, double percentile) {
+    size_t n = clock->frame_times_count;
+    if (n == 0) return 0.0;
+
+    double sorted[LM_FRAME_TIME_HISTORY];
+    memcpy(sorted, clock->frame_times, sizeof(double) * n);
+    qsort(sorted, n, sizeof(double), _lm_compare_double);
+
+    // Nearest-rank method
+    double rank = ceil(percentile / 100.0 * (double)n);
+    size_t index = rank < 1.0 ? 0 : (size_t)rank - 1;
+    if (index >= n) index = n - 1;
+
+    return sorted[index];
 }
\ No newline at end of file
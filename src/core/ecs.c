@@ -8,6 +8,8 @@
 
 */
 
+#define LM_MEMORY_TAG lmMemoryTag_ECS
+
 #include "lumina/core/ecs.h"
 #include "lumina/math/hash.h"
 
@@ -19,20 +21,12 @@
  */
 
 
-static lm_uint64 _lm_entity_hash(void *item) {
-    lmEntity *entity = (lmEntity *)item;
-    // Entity IDs are supposed to be unique so no need to hash.
-    return entity->id;
-}
-
-static lm_uint64 _lm_comp_hash(void *item) {
-    lmComponent *comp = (lmComponent *)item;
-    return lm_u64cantor(comp->id, comp->entity_id);
+static lm_uint64 _lm_system_hash(void *item) {
+    return ((lmSystem *)item)->id;
 }
 
-static lm_uint64 _lm_system_hash(void *item) {
-    lmSystem *system = (lmSystem *)item;
-    return lm_fnv1a(system->name);
+static int _lm_system_compare(void *a, void *b) {
+    return ((lmSystem *)a)->id != ((lmSystem *)b)->id;
 }
 
 
@@ -40,9 +34,10 @@ lmECS *lmECS_new() {
     lmECS *ecs = LM_NEW(lmECS);
     LM_MEMORY_ASSERT(ecs);
 
-    ecs->entities = lmHashMap_new(sizeof(lmEntity), 0, _lm_entity_hash);
-    ecs->components = lmHashMap_new(sizeof(lmComponent), 0, _lm_comp_hash);
-    ecs->systems = lmHashMap_new(sizeof(lmSystem), 0, _lm_system_hash);
+    ecs->entities = lmVec_new(sizeof(lmEntity));
+    ecs->entity_index = lmIntMap_new(0);
+    ecs->components = lmIntMap_new(0);
+    ecs->systems = lmHashMap_new(sizeof(lmSystem), 0, _lm_system_hash, _lm_system_compare);
 
     return ecs;
 }
@@ -50,42 +45,100 @@ lmECS *lmECS_new() {
 void lmECS_free(lmECS *ecs) {
     if (!ecs) return;
 
-    size_t i = 0;
-    void *item;
-    while (lmHashMap_iter(ecs->entities, &i, &item)) {
-        lmEntity *entity = (lmEntity *)item;
-        free(entity->comp_ids);
+    for (size_t i = 0; i < ecs->entities->size; i++) {
+        LM_SMALL_VEC_FREE(LM_VEC_AT(ecs->entities, lmEntity, i).comp_ids);
     }
 
-    i = 0;
-    while (lmHashMap_iter(ecs->components, &i, &item)) {
-        lmComponent *comp = (lmComponent *)item;
-        if (comp->allocated) free(comp->data);
+    size_t i = 0;
+    lm_uint64 key, value;
+    while (lmIntMap_iter(ecs->components, &i, &key, &value)) {
+        lmComponentStore *store = (lmComponentStore *)(uintptr_t)value;
+
+        for (size_t j = 0; j < store->comps->size; j++) {
+            lmComponent *comp = &LM_VEC_AT(store->comps, lmComponent, j);
+            if (comp->allocated) LM_FREE(comp->data);
+        }
+
+        lmIntMap_free(store->index);
+        lmVec_free(store->comps);
+        LM_FREE(store);
     }
 
     i = 0;
+    void *item;
     while (lmHashMap_iter(ecs->systems, &i, &item)) {
         lmSystem *system = (lmSystem *)item;
-        free(system->comp_ids);
+        LM_SMALL_VEC_FREE(system->comp_ids);
     }
 
-    lmHashMap_free(ecs->entities);
-    lmHashMap_free(ecs->components);
+    lmVec_free(ecs->entities);
+    lmIntMap_free(ecs->entity_index);
+    lmIntMap_free(ecs->components);
     lmHashMap_free(ecs->systems);
-    free(ecs);
+    LM_FREE(ecs);
 }
 
 lm_uint64 lmECS_new_entity(lmECS *ecs) {
-    lm_uint64 entity = ecs->entities->count;
+    lm_uint64 entity = ecs->entities->size;
 
-    lm_uint64 *comp_ids = (lm_uint64 *)malloc(sizeof(lm_uint64) * LM_MAX_COMPONENTS);
-    LM_MEMORY_ASSERT(comp_ids);
+    lmEntity *new_entity = lmVec_push(ecs->entities, NULL);
+    LM_MEMORY_ASSERT(new_entity);
+    new_entity->id = entity;
+    LM_SMALL_VEC_INIT(new_entity->comp_ids);
 
-    lmHashMap_set(ecs->entities, &(lmEntity){.id=entity, .comp_ids=comp_ids, .comps_size=0});
+    LM_MEMORY_ASSERT(lmIntMap_set(ecs->entity_index, entity, entity));
 
     return entity;
 }
 
+static lmComponentStore *_lmECS_get_store(lmECS *ecs, lm_uint64 comp_id) {
+    lmComponentStore *store = lmIntMap_get_ptr(ecs->components, comp_id);
+    if (store) return store;
+
+    store = LM_NEW(lmComponentStore);
+    LM_MEMORY_ASSERT(store);
+
+    store->id = comp_id;
+    store->index = lmIntMap_new(0);
+    LM_MEMORY_ASSERT(store->index);
+    store->comps = lmVec_new(sizeof(lmComponent));
+    LM_MEMORY_ASSERT(store->comps);
+
+    LM_MEMORY_ASSERT(lmIntMap_set_ptr(ecs->components, comp_id, store));
+
+    return store;
+}
+
+static void _lmECS_set_component(
+    lmECS *ecs,
+    lm_uint64 entity_id,
+    lm_uint64 comp_id,
+    void *comp_data,
+    bool allocated
+) {
+    lm_uint64 entity_index;
+    if (!lmIntMap_get(ecs->entity_index, entity_id, &entity_index))
+        LM_ERROR("Entity does not exist.");
+
+    lmComponentStore *store = _lmECS_get_store(ecs, comp_id);
+    lmComponent comp = {.id=comp_id, .entity_id=entity_id, .data=comp_data, .allocated=allocated};
+
+    // Entity already has this component, replace it
+    lm_uint64 comp_index;
+    if (lmIntMap_get(store->index, entity_id, &comp_index)) {
+        lmComponent *old = &LM_VEC_AT(store->comps, lmComponent, comp_index);
+        if (old->allocated) LM_FREE(old->data);
+        *old = comp;
+        return;
+    }
+
+    LM_MEMORY_ASSERT(lmIntMap_set(store->index, entity_id, store->comps->size));
+    LM_MEMORY_ASSERT(lmVec_push(store->comps, &comp));
+
+    lmEntity *entity = &LM_VEC_AT(ecs->entities, lmEntity, entity_index);
+    LM_MEMORY_ASSERT(LM_SMALL_VEC_PUSH(entity->comp_ids, comp_id));
+}
+
 void lmECS_add_component(
     lmECS *ecs,
     lm_uint64 entity_id,
@@ -96,13 +149,10 @@ void lmECS_add_component(
     // Copy the component data passed by user to heap so it doesn't deallocate
     // when we go out of frame.
     // The memory is handled by the entity manager.
-    void *heap_comp_data = malloc(comp_data_size);
+    void *heap_comp_data = LM_MALLOC(comp_data_size);
+    LM_MEMORY_ASSERT(heap_comp_data);
     memcpy(heap_comp_data, comp_data, comp_data_size);
-    lmHashMap_set(ecs->components, &(lmComponent){.id=comp_id, .entity_id=entity_id, .data=heap_comp_data, .allocated=true});
-
-    lmEntity *entity = lmHashMap_get(ecs->entities, &(lmEntity){.id=entity_id});
-    entity->comp_ids[entity->comps_size] = comp_id;
-    entity->comps_size++;
+    _lmECS_set_component(ecs, entity_id, comp_id, heap_comp_data, true);
 }
 
 void lmECS_add_component_p(
@@ -111,11 +161,7 @@ void lmECS_add_component_p(
     lm_uint64 comp_id,
     void *comp_data
 ) {
-    lmHashMap_set(ecs->components, &(lmComponent){.id=comp_id, .entity_id=entity_id, .data=comp_data, .allocated=false});
-
-    lmEntity *entity = lmHashMap_get(ecs->entities, &(lmEntity){.id=entity_id});
-    entity->comp_ids[entity->comps_size] = comp_id;
-    entity->comps_size++;
+    _lmECS_set_component(ecs, entity_id, comp_id, comp_data, false);
 }
 
 void lmECS_add_system(
@@ -126,13 +172,26 @@ void lmECS_add_system(
     size_t comp_ids_size,
     void *user_context
 ) {
-    lm_uint64 *heap_comp_ids = (lm_uint64 *)malloc(sizeof(lm_uint64) * comp_ids_size);
+    if (comp_ids_size > LM_MAX_COMPONENTS)
+        LM_ERROR("System requires more than LM_MAX_COMPONENTS components.");
+
+    lmStringId id = lm_intern_string(system_name);
+
+    lmSystem system = {
+        .name=lm_string_id_lookup(id),
+        .id=id,
+        .function=system_function,
+        .user_context=user_context
+    };
+    LM_SMALL_VEC_INIT(system.comp_ids);
 
     for (size_t i = 0; i < comp_ids_size; i++) {
-        heap_comp_ids[i] = comp_ids[i];
+        LM_MEMORY_ASSERT(LM_SMALL_VEC_PUSH(system.comp_ids, comp_ids[i]));
     }
 
-    lmHashMap_set(ecs->systems, &(lmSystem){.name=system_name, .function=system_function, .comp_ids=heap_comp_ids, .comp_ids_size=comp_ids_size, .user_context=user_context});
+    // Replacing a system with the same name
+    lmSystem *old = lmHashMap_set(ecs->systems, &system);
+    if (old) LM_SMALL_VEC_FREE(old->comp_ids);
 }
 
 static inline bool _lm_match_comps(lm_uint64 arr1[], size_t size1, lm_uint64 arr2[], size_t size2) {
@@ -153,25 +212,40 @@ static inline bool _lm_match_comps(lm_uint64 arr1[], size_t size1, lm_uint64 arr
 }
 
 void lmECS_run_system(lmECS *ecs, const char *system_name) {
-    lmSystem *system = (lmSystem *)lmHashMap_get(ecs->systems, &(lmSystem){.name=system_name});
-    size_t system_comps = system->comp_ids_size;
+    lmECS_run_system_by_id(ecs, lm_string_id(system_name));
+}
 
-    lmComponent **comps = (lmComponent **)malloc(sizeof(lmComponent *) * LM_MAX_COMPONENTS);
+void lmECS_run_system_by_id(lmECS *ecs, lmStringId system_id) {
+    lmSystem *system = (lmSystem *)lmHashMap_get(ecs->systems, &(lmSystem){.id=system_id});
+    size_t system_comps = system->comp_ids.size;
+    lm_uint64 *system_comp_ids = LM_SMALL_VEC_DATA(system->comp_ids);
 
-    size_t i = 0;
-    void *item;
-    while (lmHashMap_iter(ecs->entities, &i, &item)) {
-        lmEntity *entity = (lmEntity *)item;
+    // Small and bounded, no need to go to the heap every call
+    lmComponent *comps[LM_MAX_COMPONENTS];
+    lmComponentStore *stores[LM_MAX_COMPONENTS];
+
+    // Look the stores up once, a missing one means no entity can match
+    for (size_t j = 0; j < system_comps; j++) {
+        stores[j] = lmIntMap_get_ptr(ecs->components, system_comp_ids[j]);
+        if (!stores[j]) return;
+    }
+
+    for (size_t i = 0; i < ecs->entities->size; i++) {
+        lmEntity *entity = &LM_VEC_AT(ecs->entities, lmEntity, i);
 
         // Entity has all the components the system requires
-        if (_lm_match_comps(entity->comp_ids, entity->comps_size, system->comp_ids, system->comp_ids_size)) {
+        if (_lm_match_comps(
+            LM_SMALL_VEC_DATA(entity->comp_ids), entity->comp_ids.size,
+            system_comp_ids, system_comps
+        )) {
             for (size_t j = 0; j < system_comps; j++) {
-                comps[j] = lmHashMap_get(ecs->components, &(lmComponent){.id=system->comp_ids[j], .entity_id=entity->id});
+                lm_uint64 comp_index = 0;
+                if (!lmIntMap_get(stores[j]->index, entity->id, &comp_index))
+                    LM_ERROR("Entity is missing a component of its store.");
+                comps[j] = &LM_VEC_AT(stores[j]->comps, lmComponent, comp_index);
             }
 
-            system->function(entity->id, comps, system_comps, system->user_context);
+            system->function(entity->id, (lmComponents){.comps=comps, .size=system_comps}, system->user_context);
         }
     }
-
-    free(comps);
-}
\ No newline at end of file
+}
@@ -0,0 +1,245 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_RESOURCE
+
+#include "lumina/core/file_watcher.h"
+#include "lumina/core/constants.h"
+#include "lumina/math/hash.h"
+#include <sys/stat.h>
+
+#if LM_PLATFORM == LM_PLATFORM_LINUX
+    #include <unistd.h>
+    #include <sys/inotify.h>
+    #define _LM_INOTIFY
+#endif
+
+
+/**
+ * @file core/file_watcher.c
+ * 
+ * @brief Detects changes to files on disk.
+ */
+
+
+static lm_uint64 _watched_file_hasher(void *item) {
+    return lm_hash_string(((lmWatchedFile *)item)->filepath);
+}
+
+static int _watched_file_compare(void *a, void *b) {
+    return strcmp(((lmWatchedFile *)a)->filepath, ((lmWatchedFile *)b)->filepath);
+}
+
+static void _lmFileWatcher_stat(const char *filepath, lm_int64 *mtime, lm_int64 *size) {
+    struct stat st;
+
+    if (stat(filepath, &st) == 0) {
+        *mtime = (lm_int64)st.st_mtime;
+        *size = (lm_int64)st.st_size;
+    }
+    else {
+        *mtime = -1;
+        *size = -1;
+    }
+}
+
+static char *_lm_strdup(const char *str, size_t len) {
+    char *copy = LM_MALLOC(len + 1);
+    LM_MEMORY_ASSERT(copy);
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+/**
+ * @brief Push path to changed unless it's already there.
+ */
+static void _lmFileWatcher_push_changed(lmVec *changed, size_t start, const char *filepath) {
+    for (size_t i = start; i < changed->size; i++)
+        if (LM_VEC_AT(changed, const char *, i) == filepath) return;
+
+    LM_MEMORY_ASSERT(lmVec_push(changed, &filepath));
+}
+
+/**
+ * @brief Start watching the directory of a file with inotify. Returns
+ *        `false` if the file has to be polled instead.
+ */
+static bool _lmFileWatcher_watch_directory(lmFileWatcher *watcher, const char *filepath) {
+    #ifdef _LM_INOTIFY
+
+        if (watcher->inotify_fd < 0) return false;
+
+        // Watch the directory rather than the file, editors often save by
+        // writing a new file and renaming it over the old one.
+        const char *slash = strrchr(filepath, '/');
+        size_t dir_len = slash ? (size_t)(slash - filepath) : 0;
+
+        for (size_t i = 0; i < watcher->directories->size; i++) {
+            lmWatchedDirectory *dir = &LM_VEC_AT(watcher->directories, lmWatchedDirectory, i);
+            if (strlen(dir->path) == dir_len && strncmp(dir->path, filepath, dir_len) == 0)
+                return true;
+        }
+
+        lmWatchedDirectory dir;
+        dir.path = _lm_strdup(filepath, dir_len);
+        dir.wd = inotify_add_watch(
+            watcher->inotify_fd,
+            dir_len ? dir.path : ".",
+            IN_CLOSE_WRITE | IN_MOVED_TO
+        );
+
+        // Out of watches or the directory is missing, fall back to polling
+        if (dir.wd < 0) {
+            LM_FREE(dir.path);
+            return false;
+        }
+
+        LM_MEMORY_ASSERT(lmVec_push(watcher->directories, &dir));
+
+        return true;
+
+    #else
+
+        (void)watcher;
+        (void)filepath;
+        return false;
+
+    #endif
+}
+
+
+lmFileWatcher *lmFileWatcher_new() {
+    lmFileWatcher *watcher = LM_NEW(lmFileWatcher);
+    LM_MEMORY_ASSERT(watcher);
+
+    watcher->files = lmHashMap_new(
+        sizeof(lmWatchedFile), 0, _watched_file_hasher, _watched_file_compare
+    );
+    LM_MEMORY_ASSERT(watcher->files);
+
+    watcher->directories = lmVec_new(sizeof(lmWatchedDirectory));
+    LM_MEMORY_ASSERT(watcher->directories);
+
+    #ifdef _LM_INOTIFY
+        // Fall back to polling if inotify is out of instances
+        watcher->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    #else
+        watcher->inotify_fd = -1;
+    #endif
+
+    watcher->last_poll = SDL_GetTicks64();
+    watcher->polled_count = 0;
+
+    return watcher;
+}
+
+void lmFileWatcher_free(lmFileWatcher *watcher) {
+    if (!watcher) return;
+
+    size_t iter = 0;
+    void *item;
+    while (lmHashMap_iter(watcher->files, &iter, &item))
+        LM_FREE(((lmWatchedFile *)item)->filepath);
+
+    for (size_t i = 0; i < watcher->directories->size; i++)
+        LM_FREE(LM_VEC_AT(watcher->directories, lmWatchedDirectory, i).path);
+
+    #ifdef _LM_INOTIFY
+        if (watcher->inotify_fd >= 0) close(watcher->inotify_fd);
+    #endif
+
+    lmHashMap_free(watcher->files);
+    lmVec_free(watcher->directories);
+    LM_FREE(watcher);
+}
+
+void lmFileWatcher_add(lmFileWatcher *watcher, const char *filepath) {
+    if (lmHashMap_get(watcher->files, &(lmWatchedFile){.filepath=(char *)filepath}))
+        return;
+
+    lmWatchedFile file;
+    file.filepath = _lm_strdup(filepath, strlen(filepath));
+    _lmFileWatcher_stat(filepath, &file.mtime, &file.size);
+    file.polled = !_lmFileWatcher_watch_directory(watcher, filepath);
+
+    if (file.polled) watcher->polled_count++;
+
+    lmHashMap_set(watcher->files, &file);
+}
+
+size_t lmFileWatcher_poll(lmFileWatcher *watcher, lmVec *changed) {
+    size_t start = changed->size;
+
+    #ifdef _LM_INOTIFY
+
+        if (watcher->inotify_fd >= 0) {
+            char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+            char filepath[4096];
+
+            for (;;) {
+                ssize_t length = read(watcher->inotify_fd, buffer, sizeof(buffer));
+                if (length <= 0) break;
+
+                for (char *ptr = buffer; ptr < buffer + length;) {
+                    struct inotify_event *event = (struct inotify_event *)ptr;
+                    ptr += sizeof(struct inotify_event) + event->len;
+
+                    if (event->len == 0) continue;
+
+                    for (size_t i = 0; i < watcher->directories->size; i++) {
+                        lmWatchedDirectory *dir = &LM_VEC_AT(watcher->directories, lmWatchedDirectory, i);
+                        if (dir->wd != event->wd) continue;
+
+                        if (dir->path[0] == '\0')
+                            snprintf(filepath, sizeof(filepath), "%s", event->name);
+                        else
+                            snprintf(filepath, sizeof(filepath), "%s/%s", dir->path, event->name);
+
+                        lmWatchedFile *file = lmHashMap_get(
+                            watcher->files, &(lmWatchedFile){.filepath=filepath}
+                        );
+                        if (file) _lmFileWatcher_push_changed(changed, start, file->filepath);
+
+                        break;
+                    }
+                }
+            }
+        }
+
+    #endif
+
+    if (watcher->polled_count == 0) return changed->size - start;
+
+    lm_uint64 now = SDL_GetTicks64();
+    if (now - watcher->last_poll < LM_FILE_WATCHER_POLL_INTERVAL) return changed->size - start;
+    watcher->last_poll = now;
+
+    size_t iter = 0;
+    void *item;
+    while (lmHashMap_iter(watcher->files, &iter, &item)) {
+        lmWatchedFile *file = (lmWatchedFile *)item;
+        if (!file->polled) continue;
+
+        lm_int64 mtime, size;
+        _lmFileWatcher_stat(file->filepath, &mtime, &size);
+
+        // Ignore the file while it's missing, it's probably being replaced
+        if (mtime < 0) continue;
+
+        if (mtime != file->mtime || size != file->size) {
+            file->mtime = mtime;
+            file->size = size;
+            _lmFileWatcher_push_changed(changed, start, file->filepath);
+        }
+    }
+
+    return changed->size - start;
+}
@@ -8,10 +8,10 @@
 
 */
 
+#define LM_MEMORY_TAG lmMemoryTag_CORE
+
 #include "lumina/core/game.h"
 #include "lumina/core/constants.h"
-#include "lumina/core/hwinfo.h"
-#include "lumina/graphics/draw.h"
 
 
 /**
@@ -53,9 +53,18 @@ lmGame *lmGame_new(lmGameDef game_def) {
     );
 
     game->resource_manager = lmResourceManager_new();
+    game->resource_manager->upload_budget = game_def.upload_budget;
+    game->resource_manager->texture_budget = game_def.texture_budget;
+    game->thread_pool = lmThreadPool_new(game_def.worker_threads);
+
+    // Loose asset files are used when there is no pack
+    if (game_def.asset_pack) lmResource_mount_pack(game, game_def.asset_pack);
+    if (game_def.hot_reload) lmResource_enable_hot_reload(game);
+
     lmResource_load_font(game, "assets/FiraCode-SemiBold.ttf", 12);
 
     game->ecs = lmECS_new();
+    game->transforms = lmTransformHierarchy_new();
 
     game->on_ready = game_def.on_ready;
     game->on_update = game_def.on_update;
@@ -63,6 +72,60 @@ lmGame *lmGame_new(lmGameDef game_def) {
 
     game->target_fps = game_def.target_fps;
     game->clock = lmClock_new();
+    game->clock->pacing = game_def.frame_pacing;
+
+    game->fixed_timestep = game_def.fixed_timestep;
+    game->max_ticks_per_frame = game_def.max_ticks_per_frame;
+    if (game->fixed_timestep && game_def.tick_rate == 0)
+        LM_ERROR("Tick rate has to be above 0 with fixed timestep.");
+    if (game->fixed_timestep && game_def.max_ticks_per_frame == 0)
+        LM_ERROR("Max ticks per frame has to be above 0 with fixed timestep.");
+    game->fixed_dt = game_def.tick_rate ? 1.0 / (double)game_def.tick_rate : 0.0;
+    game->accumulator = 0.0;
+    game->alpha = 0.0;
+    game->update_dt = 0.0;
+
+    #ifdef LM_WEB
+        // Threads are not available without SharedArrayBuffer support
+        game->threaded_update = false;
+    #else
+        game->threaded_update = game_def.threaded_update;
+    #endif
+
+    game->on_snapshot = game_def.on_snapshot;
+    game->snapshot_size = game_def.snapshot_size;
+    game->snapshots[0] = NULL;
+    game->snapshots[1] = NULL;
+    if (game->snapshot_size > 0) {
+        game->snapshots[0] = LM_MALLOC(game->snapshot_size);
+        LM_MEMORY_ASSERT(game->snapshots[0]);
+        game->snapshots[1] = LM_MALLOC(game->snapshot_size);
+        LM_MEMORY_ASSERT(game->snapshots[1]);
+    }
+    game->snapshot_index = 0;
+    game->snapshot = game->snapshots[0];
+    game->rendered_entities = 0;
+
+    game->sim_thread = NULL;
+    game->sim_start = NULL;
+    game->sim_done = NULL;
+    game->sim_quit = false;
+    game->sim_frame_dt = 0.0;
+    game->sim_alpha = 0.0;
+
+    game->frame_arena = lmFrameArena_new(game_def.frame_arena_capacity);
+    if (game->threaded_update)
+        game->update_arena = lmFrameArena_new(game_def.frame_arena_capacity);
+    else
+        game->update_arena = game->frame_arena;
+
+    game->overlay = NULL;
+    if (game_def.show_stats) {
+        lmFont *font = lmResource_get_font_by_id(
+            game, LM_SID("assets/FiraCode-SemiBold.ttf"), 12, TTF_STYLE_NORMAL
+        );
+        game->overlay = lmOverlay_new(game, font, game_def.stats_interval);
+    }
 
     game->is_running = false;
 
@@ -74,20 +137,115 @@ lmGame *lmGame_new(lmGameDef game_def) {
 void lmGame_free(lmGame *game) {
     if (!game) return;
 
+    // Stop the workers before freeing what their jobs use
+    lmThreadPool_free(game->thread_pool);
+    lmOverlay_free(game->overlay);
+    // Textures have to be destroyed before their renderer
+    lmResourceManager_free(game->resource_manager);
     lmWindow_free(game->window);
     lmClock_free(game->clock);
-    lmResourceManager_free(game->resource_manager);
     lmECS_free(game->ecs);
-    free(game);
+    lmTransformHierarchy_free(game->transforms);
+    if (game->update_arena != game->frame_arena) lmFrameArena_free(game->update_arena);
+    lmFrameArena_free(game->frame_arena);
+    LM_FREE(game->snapshots[0]);
+    LM_FREE(game->snapshots[1]);
+    if (game->sim_start) SDL_DestroySemaphore(game->sim_start);
+    if (game->sim_done) SDL_DestroySemaphore(game->sim_done);
+    LM_FREE(game);
+
+    // Resources and systems point to interned strings
+    lm_string_ids_free();
 
     SDL_Quit();
     TTF_Quit();
     IMG_Quit();
 }
 
+/**
+ * @brief Advance the simulation by the frame's delta time and return the
+ *        interpolation factor for rendering.
+ */
+static double _lmGame_update(lmGame *game, double dt) {
+    lmTransformHierarchy_begin_frame(game->transforms);
+
+    if (!game->fixed_timestep) {
+        game->update_dt = dt;
+        if (game->on_update) game->on_update(game);
+        lmTransformHierarchy_update(game->transforms);
+        return 1.0;
+    }
+
+    game->accumulator += dt;
+    game->update_dt = game->fixed_dt;
+
+    lm_uint16 ticks = 0;
+    while (game->accumulator >= game->fixed_dt) {
+        // Drop the time we couldn't catch up to, otherwise a slow frame
+        // causes more ticks next frame and the simulation never recovers.
+        if (ticks >= game->max_ticks_per_frame) {
+            game->accumulator = 0.0;
+            break;
+        }
+
+        if (game->on_update) game->on_update(game);
+        lmTransformHierarchy_update(game->transforms);
+        game->accumulator -= game->fixed_dt;
+        ticks++;
+    }
+
+    return game->accumulator / game->fixed_dt;
+}
+
+static int _lmGame_simulation_thread(void *game_p) {
+    lmGame *game = (lmGame *)game_p;
+
+    while (true) {
+        SDL_SemWait(game->sim_start);
+        if (game->sim_quit) break;
+
+        lmFrameArena_reset(game->update_arena);
+        game->sim_alpha = _lmGame_update(game, game->sim_frame_dt);
+
+        // Write into the buffer the renderer is not reading from
+        if (game->on_snapshot)
+            game->on_snapshot(game, game->snapshots[game->snapshot_index ^ 1]);
+
+        SDL_SemPost(game->sim_done);
+    }
+
+    return 0;
+}
+
+static void _lmGame_start_simulation_thread(lmGame *game) {
+    game->sim_start = SDL_CreateSemaphore(0);
+    game->sim_done = SDL_CreateSemaphore(0);
+    if (!game->sim_start || !game->sim_done) LM_ERROR(SDL_GetError());
+
+    game->sim_quit = false;
+    game->sim_thread = SDL_CreateThread(_lmGame_simulation_thread, "lumina_simulation", game);
+    if (!game->sim_thread) LM_ERROR(SDL_GetError());
+
+    // Simulate the first frame so there is a snapshot to render
+    SDL_SemPost(game->sim_start);
+}
+
+static void _lmGame_stop_simulation_thread(lmGame *game) {
+    // Wait for the frame in flight, then wake the thread up to exit
+    SDL_SemWait(game->sim_done);
+    game->sim_quit = true;
+    SDL_SemPost(game->sim_start);
+
+    SDL_WaitThread(game->sim_thread, NULL);
+    game->sim_thread = NULL;
+}
+
 static void lmGame_main_loop(void *game_p) {
     lmGame *game = (lmGame *)game_p;
 
+    // The simulation thread resets its own arena
+    lmFrameArena_reset(game->frame_arena);
+
     lmClock_tick(game->clock, game->target_fps);
 
     SDL_Event event;
@@ -96,57 +254,39 @@ static void lmGame_main_loop(void *game_p) {
             game->is_running = false;
     }
 
-    if (game->on_update) game->on_update(game);
+    lmResource_update(game);
 
-    SDL_SetRenderDrawColor(game->window->sdl_renderer, 255, 255, 255, 255);
-    SDL_RenderClear(game->window->sdl_renderer);
-
-    if (game->on_render) game->on_render(game);
-
-    //lmFont *font = lmResourceManager_get_font("FiraCode", 18);
-    lmFont *font = lmResource_get_font(game, "assets/FiraCode-SemiBold.ttf", 12);
-    lmColor text_color = (lmColor){255, 255, 255, 255};
+    if (game->threaded_update) {
+        // Wait for the simulation of this frame, then let the simulation
+        // of the next frame run while we render this one.
+        SDL_SemWait(game->sim_done);
 
-    SDL_SetRenderDrawColor(game->window->sdl_renderer, 0, 0, 0, 150);
-    SDL_RenderFillRect(game->window->sdl_renderer, &(SDL_Rect){0, 0, 220, 92});
+        // Only this thread is running here, so it's safe to free what the
+        // resource manager retired.
+        lmResourceManager_collect(game->resource_manager);
 
-    // char text0[24];
-    // sprintf(text0, "Lumina %d.%d.%d", LM_VERSION_MAJOR, LM_VERSION_MINOR, LM_VERSION_PATCH);
-    // lm_draw_text(game, font, text0, 5, 5 + (16 * 0), text_color);
+        game->snapshot_index ^= 1;
+        game->snapshot = game->snapshots[game->snapshot_index];
+        game->alpha = game->sim_alpha;
+        game->rendered_entities = game->ecs->entities->size;
 
-    char text1[24];
-    sprintf(text1, "SDL %d.%d.%d", SDL_MAJOR_VERSION, SDL_MINOR_VERSION, SDL_PATCHLEVEL);
-    lm_draw_text(game, font, text1, 5, 5 + (16 * 0), text_color);
-
-    char text2[16];
-    sprintf(text2, "FPS: %.1f", game->clock->fps);
-    lm_draw_text(game, font, text2, 5, 5 + (16 * 1), text_color);
-
-    char text3[24];
-    sprintf(text3, "Entities: %llu", (unsigned long long)game->ecs->entities->count);
-    lm_draw_text(game, font, text3, 5, 5 + (16 * 2), text_color);
+        game->sim_frame_dt = game->clock->dt;
+        SDL_SemPost(game->sim_start);
+    }
+    else {
+        game->alpha = _lmGame_update(game, game->clock->dt);
+        lmResourceManager_collect(game->resource_manager);
 
-    char text4[64];
+        if (game->on_snapshot) game->on_snapshot(game, game->snapshot);
+        game->rendered_entities = game->ecs->entities->size;
+    }
 
-    SDL_RendererInfo info;
-    SDL_GetRendererInfo(game->window->sdl_renderer, &info);
-    char *driver;
-    if (strcmp(info.name, "direct3d") == 0) driver = "Direct3D";
-    else if (strcmp(info.name, "opengl") == 0) driver = "OpenGL";
-    else if (strcmp(info.name, "opengles2") == 0) driver = "OpenGL ES 2.0";
-    else if (strcmp(info.name, "opengles") == 0) driver = "OpenGL ES";
-    else if (strcmp(info.name, "metal") == 0) driver = "Metal";
-    else if (strcmp(info.name, "software") == 0) driver = "Software";
-    else driver = "Unknown";
+    SDL_SetRenderDrawColor(game->window->sdl_renderer, 255, 255, 255, 255);
+    SDL_RenderClear(game->window->sdl_renderer);
 
-    sprintf(text4, "Renderer: SDL2 (%s)", driver);
-    lm_draw_text(game, font, text4, 5, 5 + (16 * 3), text_color);
+    if (game->on_render) game->on_render(game);
 
-    char text5[16];
-    size_t memory_used = lm_get_current_memory_usage();
-    double memory_used_mb = (double)memory_used / 1048576.0;
-    sprintf(text5, "Memory: %.1fMB", memory_used_mb);
-    lm_draw_text(game, font, text5, 5, 5 + (16 * 4), text_color);
+    if (game->overlay) lmOverlay_render(game->overlay, game);
 
     SDL_RenderPresent(game->window->sdl_renderer);
 }
@@ -161,9 +301,13 @@ void lmGame_run(lmGame *game) {
 
     #else
 
+        if (game->threaded_update) _lmGame_start_simulation_thread(game);
+
         while (game->is_running) {
             lmGame_main_loop(game);
         }
 
+        if (game->threaded_update) _lmGame_stop_simulation_thread(game);
+
     #endif
 }
\ No newline at end of file
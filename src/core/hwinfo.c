@@ -13,6 +13,10 @@
 #if LM_PLATFORM == LM_PLATFORM_WINDOWS
     #include <windows.h>
     #include <psapi.h>
+#elif LM_PLATFORM != LM_PLATFORM_WEB
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/resource.h>
 #endif
 
 
@@ -23,10 +27,40 @@
  */
 
 
-size_t lm_get_current_memory_usage() {
+#if LM_PLATFORM != LM_PLATFORM_WEB && LM_PLATFORM != LM_PLATFORM_WINDOWS
+
+/*
+    The statm file descriptor is opened once and read with pread, so sampling
+    doesn't open, lock or buffer anything. Stored as fd + 1 so 0 means unopened.
+*/
+static SDL_atomic_t _lm_statm_fd = {0};
+
+static int _lm_get_statm_fd() {
+    int fd = SDL_AtomicGet(&_lm_statm_fd) - 1;
+    if (fd >= 0) return fd;
+
+    fd = open("/proc/self/statm", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    // Another thread might have opened it meanwhile
+    if (!SDL_AtomicCAS(&_lm_statm_fd, 0, fd + 1)) {
+        close(fd);
+        fd = SDL_AtomicGet(&_lm_statm_fd) - 1;
+    }
+
+    return fd;
+}
+
+#endif
+
+
+lmMemoryStats lm_get_memory_stats() {
+    lmMemoryStats stats = {0, 0, 0, 0};
+    stats.heap_bytes = lm_get_tracked_heap_bytes();
+
     #if LM_PLATFORM == LM_PLATFORM_WEB
 
-        return 0;
+        return stats;
 
     #elif LM_PLATFORM == LM_PLATFORM_WINDOWS
 
@@ -36,29 +70,51 @@ size_t lm_get_current_memory_usage() {
         PROCESS_MEMORY_COUNTERS_EX pmc;
 
         if (GetProcessMemoryInfo(current_process, (PROCESS_MEMORY_COUNTERS *)&pmc, sizeof(pmc))) {
-            return pmc.WorkingSetSize;
-        }
-        else {
-            return 0;
+            stats.rss = pmc.WorkingSetSize;
+            stats.peak_rss = pmc.PeakWorkingSetSize;
+            stats.virtual_size = pmc.PrivateUsage;
         }
 
+        return stats;
+
     #else
 
-        FILE *status = fopen("/proc/self/status", "r");
-        
-        if (status) {
-            char line[128];
-            while (fgets(line, 128, status) != NULL) {
-                if (strncmp(line, "VmSize:", 7) == 0) {
-                    char *val = line + 7;
-                    fclose(status);
-                    return strtoul(val, NULL, 10) * 1024;
-                }
+        // https://man7.org/linux/man-pages/man5/proc.5.html (/proc/pid/statm)
+        // Fields are in pages: size resident shared text lib data dt
+
+        int fd = _lm_get_statm_fd();
+        if (fd >= 0) {
+            char buffer[128];
+            ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+
+            if (n > 0) {
+                buffer[n] = '\0';
+
+                size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+                char *end;
+                size_t size = strtoul(buffer, &end, 10);
+                size_t resident = strtoul(end, NULL, 10);
+
+                stats.virtual_size = size * page_size;
+                stats.rss = resident * page_size;
             }
         }
-        
-        fclose(status);
-        return 0;
+
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            #if LM_PLATFORM == LM_PLATFORM_MACOS || LM_PLATFORM == LM_PLATFORM_IOS
+                // Reported in bytes on Apple platforms
+                stats.peak_rss = (size_t)usage.ru_maxrss;
+            #else
+                stats.peak_rss = (size_t)usage.ru_maxrss * 1024;
+            #endif
+        }
+
+        return stats;
 
     #endif
+}
+
+size_t lm_get_current_memory_usage() {
+    return lm_get_memory_stats().rss;
 }
\ No newline at end of file
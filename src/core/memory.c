@@ -0,0 +1,219 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#include "lumina/core/memory.h"
+#include "lumina/_lumina.h"
+
+
+/**
+ * @file core/memory.c
+ * 
+ * @brief Pluggable allocator and per-subsystem memory tracking.
+ */
+
+
+static void *_lm_default_alloc(size_t size, void *user_data) {
+    return malloc(size);
+}
+
+static void *_lm_default_realloc(void *ptr, size_t size, void *user_data) {
+    return realloc(ptr, size);
+}
+
+static void _lm_default_free(void *ptr, void *user_data) {
+    free(ptr);
+}
+
+static lmAllocator _lm_allocator = {
+    .alloc = _lm_default_alloc,
+    .realloc = _lm_default_realloc,
+    .free = _lm_default_free,
+    .user_data = NULL
+};
+
+
+#ifndef LM_NO_MEMORY_TRACKING
+
+/*
+    Each tracked allocation is prefixed with its size and tag. The header is
+    padded to max_align_t so the returned memory keeps malloc's alignment.
+*/
+typedef union {
+    struct {
+        size_t size;
+        lmMemoryTag tag;
+    } info;
+    max_align_t _align;
+} _lmAllocationHeader;
+
+// Counters are updated atomically since allocations can happen on any thread
+static lmMemoryTagStats _lm_tag_stats[lmMemoryTag_COUNT];
+
+static inline void _lm_track_grow(lmMemoryTag tag, size_t size) {
+    lmMemoryTagStats *stats = &_lm_tag_stats[tag];
+
+    size_t bytes = __atomic_add_fetch(&stats->bytes, size, __ATOMIC_RELAXED);
+
+    size_t peak = __atomic_load_n(&stats->peak_bytes, __ATOMIC_RELAXED);
+    while (bytes > peak) {
+        if (__atomic_compare_exchange_n(
+            &stats->peak_bytes, &peak, bytes, true,
+            __ATOMIC_RELAXED, __ATOMIC_RELAXED
+        )) break;
+    }
+}
+
+static inline void _lm_track_alloc(lmMemoryTag tag, size_t size) {
+    lmMemoryTagStats *stats = &_lm_tag_stats[tag];
+
+    __atomic_add_fetch(&stats->allocations, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&stats->total_allocations, 1, __ATOMIC_RELAXED);
+    _lm_track_grow(tag, size);
+}
+
+static inline void _lm_track_free(lmMemoryTag tag, size_t size) {
+    lmMemoryTagStats *stats = &_lm_tag_stats[tag];
+
+    __atomic_sub_fetch(&stats->bytes, size, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&stats->allocations, 1, __ATOMIC_RELAXED);
+}
+
+#endif
+
+
+const char *lmMemoryTag_as_string(lmMemoryTag tag) {
+    switch (tag) {
+        case lmMemoryTag_GENERAL:
+            return "General";
+
+        case lmMemoryTag_CORE:
+            return "Core";
+
+        case lmMemoryTag_COLLECTIONS:
+            return "Collections";
+
+        case lmMemoryTag_ECS:
+            return "ECS";
+
+        case lmMemoryTag_RESOURCE:
+            return "Resource";
+
+        case lmMemoryTag_GRAPHICS:
+            return "Graphics";
+
+        case lmMemoryTag_USER:
+            return "User";
+
+        default:
+            return "Unknown";
+    }
+}
+
+void lm_set_allocator(lmAllocator allocator) {
+    _lm_allocator = allocator;
+}
+
+lmAllocator lm_get_allocator() {
+    return _lm_allocator;
+}
+
+void *lm_malloc(size_t size, lmMemoryTag tag) {
+    #ifdef LM_NO_MEMORY_TRACKING
+
+        return _lm_allocator.alloc(size, _lm_allocator.user_data);
+
+    #else
+
+        _lmAllocationHeader *header = _lm_allocator.alloc(
+            sizeof(_lmAllocationHeader) + size, _lm_allocator.user_data
+        );
+        if (!header) return NULL;
+
+        header->info.size = size;
+        header->info.tag = tag;
+        _lm_track_alloc(tag, size);
+
+        return header + 1;
+
+    #endif
+}
+
+void *lm_realloc(void *ptr, size_t size, lmMemoryTag tag) {
+    #ifdef LM_NO_MEMORY_TRACKING
+
+        return _lm_allocator.realloc(ptr, size, _lm_allocator.user_data);
+
+    #else
+
+        if (!ptr) return lm_malloc(size, tag);
+
+        _lmAllocationHeader *header = (_lmAllocationHeader *)ptr - 1;
+        size_t old_size = header->info.size;
+        lmMemoryTag old_tag = header->info.tag;
+
+        header = _lm_allocator.realloc(
+            header, sizeof(_lmAllocationHeader) + size, _lm_allocator.user_data
+        );
+        if (!header) return NULL;
+
+        header->info.size = size;
+        if (size > old_size)
+            _lm_track_grow(old_tag, size - old_size);
+        else
+            __atomic_sub_fetch(&_lm_tag_stats[old_tag].bytes, old_size - size, __ATOMIC_RELAXED);
+
+        return header + 1;
+
+    #endif
+}
+
+void lm_free(void *ptr) {
+    if (!ptr) return;
+
+    #ifdef LM_NO_MEMORY_TRACKING
+
+        _lm_allocator.free(ptr, _lm_allocator.user_data);
+
+    #else
+
+        _lmAllocationHeader *header = (_lmAllocationHeader *)ptr - 1;
+        _lm_track_free(header->info.tag, header->info.size);
+
+        _lm_allocator.free(header, _lm_allocator.user_data);
+
+    #endif
+}
+
+lmMemoryTagStats lm_get_memory_tag_stats(lmMemoryTag tag) {
+    lmMemoryTagStats stats = {0, 0, 0, 0};
+
+    #ifndef LM_NO_MEMORY_TRACKING
+
+        if (tag >= lmMemoryTag_COUNT) return stats;
+
+        stats.bytes = __atomic_load_n(&_lm_tag_stats[tag].bytes, __ATOMIC_RELAXED);
+        stats.peak_bytes = __atomic_load_n(&_lm_tag_stats[tag].peak_bytes, __ATOMIC_RELAXED);
+        stats.allocations = __atomic_load_n(&_lm_tag_stats[tag].allocations, __ATOMIC_RELAXED);
+        stats.total_allocations = __atomic_load_n(&_lm_tag_stats[tag].total_allocations, __ATOMIC_RELAXED);
+
+    #endif
+
+    return stats;
+}
+
+size_t lm_get_tracked_heap_bytes() {
+    size_t bytes = 0;
+
+    for (size_t i = 0; i < lmMemoryTag_COUNT; i++) {
+        bytes += lm_get_memory_tag_stats(i).bytes;
+    }
+
+    return bytes;
+}
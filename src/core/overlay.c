@@ -0,0 +1,202 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_CORE
+
+#include "lumina/core/overlay.h"
+#include "lumina/core/game.h"
+#include "lumina/core/hwinfo.h"
+
+
+/**
+ * @file core/overlay.c
+ * 
+ * @brief Debug statistics overlay.
+ */
+
+
+typedef enum {
+    _lmOverlayLine_SDL,
+    _lmOverlayLine_FPS,
+    _lmOverlayLine_FRAME_TIME,
+    _lmOverlayLine_ENTITIES,
+    _lmOverlayLine_RENDERER,
+    _lmOverlayLine_MEMORY
+} _lmOverlayLineIndex;
+
+
+static void _lmOverlay_set_line(
+    lmOverlay *overlay,
+    SDL_Renderer *renderer,
+    size_t index,
+    const char *text
+) {
+    lmOverlayLine *line = &overlay->lines[index];
+
+    if (line->texture) SDL_DestroyTexture(line->texture);
+    line->texture = NULL;
+
+    SDL_Surface *text_surf = TTF_RenderText_Blended(
+        overlay->font->ttf, text, (SDL_Color){255, 255, 255, 255}
+    );
+    if (!text_surf) return;
+
+    line->texture = SDL_CreateTextureFromSurface(renderer, text_surf);
+    SDL_FreeSurface(text_surf);
+
+    SDL_QueryTexture(line->texture, NULL, NULL, &line->width, &line->height);
+}
+
+static size_t _lmOverlay_get_memory(lmOverlay *overlay) {
+    SDL_AtomicLock(&overlay->memory_lock);
+    size_t memory_used = overlay->memory_used;
+    SDL_AtomicUnlock(&overlay->memory_lock);
+
+    return memory_used;
+}
+
+static int _lmOverlay_memory_thread(void *overlay_p) {
+    lmOverlay *overlay = (lmOverlay *)overlay_p;
+    lm_uint32 interval = (lm_uint32)(overlay->interval * 1000.0);
+    if (interval == 0) interval = 1;
+
+    do {
+        size_t memory_used = lm_get_current_memory_usage();
+
+        SDL_AtomicLock(&overlay->memory_lock);
+        overlay->memory_used = memory_used;
+        SDL_AtomicUnlock(&overlay->memory_lock);
+
+    // Sleep for the interval unless we are told to quit
+    } while (SDL_SemWaitTimeout(overlay->memory_quit, interval) == SDL_MUTEX_TIMEDOUT);
+
+    return 0;
+}
+
+static void _lmOverlay_refresh(lmOverlay *overlay, lmGame *game) {
+    SDL_Renderer *renderer = game->window->sdl_renderer;
+
+    char text[64];
+
+    sprintf(text, "FPS: %.1f", game->clock->fps);
+    _lmOverlay_set_line(overlay, renderer, _lmOverlayLine_FPS, text);
+
+    sprintf(
+        text,
+        "Frame: %.2fms (p99 %.2fms)",
+        game->clock->frame_time_p50,
+        game->clock->frame_time_p99
+    );
+    _lmOverlay_set_line(overlay, renderer, _lmOverlayLine_FRAME_TIME, text);
+
+    sprintf(text, "Entities: %llu", (unsigned long long)game->rendered_entities);
+    _lmOverlay_set_line(overlay, renderer, _lmOverlayLine_ENTITIES, text);
+
+    #ifdef LM_WEB
+        // No threads to sample on, it's cheap to do it here since we only
+        // sample once per interval anyway.
+        overlay->memory_used = lm_get_current_memory_usage();
+    #endif
+
+    double memory_used_mb = (double)_lmOverlay_get_memory(overlay) / 1048576.0;
+    sprintf(text, "Memory (RSS): %.1fMB", memory_used_mb);
+    _lmOverlay_set_line(overlay, renderer, _lmOverlayLine_MEMORY, text);
+
+    overlay->last_refresh = game->clock->time;
+}
+
+
+lmOverlay *lmOverlay_new(lmGame *game, lmFont *font, double interval) {
+    lmOverlay *overlay = LM_NEW(lmOverlay);
+    LM_MEMORY_ASSERT(overlay);
+
+    SDL_Renderer *renderer = game->window->sdl_renderer;
+
+    overlay->font = font;
+    overlay->interval = interval;
+    overlay->last_refresh = -interval;
+
+    for (size_t i = 0; i < LM_OVERLAY_LINES; i++) {
+        overlay->lines[i] = (lmOverlayLine){.texture=NULL, .width=0, .height=0};
+    }
+
+    overlay->memory_used = 0;
+    overlay->memory_lock = 0;
+    overlay->memory_thread = NULL;
+    overlay->memory_quit = NULL;
+
+    // Lines that never change are rasterized only once
+
+    char text[64];
+
+    sprintf(text, "SDL %d.%d.%d", SDL_MAJOR_VERSION, SDL_MINOR_VERSION, SDL_PATCHLEVEL);
+    _lmOverlay_set_line(overlay, renderer, _lmOverlayLine_SDL, text);
+
+    SDL_RendererInfo info;
+    SDL_GetRendererInfo(renderer, &info);
+    char *driver;
+    if (strcmp(info.name, "direct3d") == 0) driver = "Direct3D";
+    else if (strcmp(info.name, "opengl") == 0) driver = "OpenGL";
+    else if (strcmp(info.name, "opengles2") == 0) driver = "OpenGL ES 2.0";
+    else if (strcmp(info.name, "opengles") == 0) driver = "OpenGL ES";
+    else if (strcmp(info.name, "metal") == 0) driver = "Metal";
+    else if (strcmp(info.name, "software") == 0) driver = "Software";
+    else driver = "Unknown";
+
+    sprintf(text, "Renderer: SDL2 (%s)", driver);
+    _lmOverlay_set_line(overlay, renderer, _lmOverlayLine_RENDERER, text);
+
+    #ifndef LM_WEB
+        overlay->memory_quit = SDL_CreateSemaphore(0);
+        if (!overlay->memory_quit) LM_ERROR(SDL_GetError());
+
+        overlay->memory_thread = SDL_CreateThread(
+            _lmOverlay_memory_thread, "lumina_memory_sampler", overlay
+        );
+        if (!overlay->memory_thread) LM_ERROR(SDL_GetError());
+    #endif
+
+    return overlay;
+}
+
+void lmOverlay_free(lmOverlay *overlay) {
+    if (!overlay) return;
+
+    if (overlay->memory_thread) {
+        SDL_SemPost(overlay->memory_quit);
+        SDL_WaitThread(overlay->memory_thread, NULL);
+    }
+    if (overlay->memory_quit) SDL_DestroySemaphore(overlay->memory_quit);
+
+    for (size_t i = 0; i < LM_OVERLAY_LINES; i++) {
+        if (overlay->lines[i].texture) SDL_DestroyTexture(overlay->lines[i].texture);
+    }
+
+    LM_FREE(overlay);
+}
+
+void lmOverlay_render(lmOverlay *overlay, lmGame *game) {
+    SDL_Renderer *renderer = game->window->sdl_renderer;
+
+    if (game->clock->time - overlay->last_refresh >= overlay->interval) {
+        _lmOverlay_refresh(overlay, game);
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 150);
+    SDL_RenderFillRect(renderer, &(SDL_Rect){0, 0, 220, 10 + 16 * LM_OVERLAY_LINES});
+
+    for (size_t i = 0; i < LM_OVERLAY_LINES; i++) {
+        lmOverlayLine *line = &overlay->lines[i];
+        if (!line->texture) continue;
+
+        SDL_FRect line_rect = {5.0, 5.0 + 16.0 * i, line->width, line->height};
+        SDL_RenderCopyF(renderer, line->texture, NULL, &line_rect);
+    }
+}
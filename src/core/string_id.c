@@ -0,0 +1,97 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_CORE
+
+#include "lumina/core/string_id.h"
+#include "lumina/collections/intmap.h"
+
+
+/**
+ * @file core/string_id.c
+ * 
+ * @brief Interned string IDs.
+ */
+
+
+// String ID -> interned string, created on first use
+static lmIntMap *_lm_strings = NULL;
+
+// Interning is rare and short, a spinlock is enough
+static int _lm_strings_lock = 0;
+
+static void _lm_strings_acquire() {
+    while (__atomic_exchange_n(&_lm_strings_lock, 1, __ATOMIC_ACQUIRE))
+        while (__atomic_load_n(&_lm_strings_lock, __ATOMIC_RELAXED));
+}
+
+static void _lm_strings_release() {
+    __atomic_store_n(&_lm_strings_lock, 0, __ATOMIC_RELEASE);
+}
+
+
+lmStringId lm_intern_string(const char *str) {
+    lmStringId id = lm_string_id(str);
+
+    _lm_strings_acquire();
+
+    if (!_lm_strings) {
+        _lm_strings = lmIntMap_new(0);
+        LM_MEMORY_ASSERT(_lm_strings);
+    }
+
+    const char *interned = lmIntMap_get_ptr(_lm_strings, id);
+    if (interned) {
+        _lm_strings_release();
+
+        if (strcmp(interned, str) != 0) LM_ERROR("String ID collision.");
+
+        return id;
+    }
+
+    size_t len = strlen(str) + 1;
+    char *copy = LM_MALLOC(len);
+    LM_MEMORY_ASSERT(copy);
+    memcpy(copy, str, len);
+
+    LM_MEMORY_ASSERT(lmIntMap_set_ptr(_lm_strings, id, copy));
+
+    _lm_strings_release();
+
+    return id;
+}
+
+const char *lm_string_id_lookup(lmStringId id) {
+    const char *str = NULL;
+
+    _lm_strings_acquire();
+
+    if (_lm_strings) str = lmIntMap_get_ptr(_lm_strings, id);
+
+    _lm_strings_release();
+
+    return str;
+}
+
+void lm_string_ids_free() {
+    _lm_strings_acquire();
+
+    if (_lm_strings) {
+        size_t i = 0;
+        lm_uint64 key, value;
+        while (lmIntMap_iter(_lm_strings, &i, &key, &value))
+            LM_FREE((void *)(uintptr_t)value);
+
+        lmIntMap_free(_lm_strings);
+        _lm_strings = NULL;
+    }
+
+    _lm_strings_release();
+}
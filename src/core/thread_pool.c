@@ -0,0 +1,116 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_CORE
+
+#include "lumina/core/thread_pool.h"
+#include "lumina/core/constants.h"
+
+
+/**
+ * @file core/thread_pool.c
+ * 
+ * @brief Pool of worker threads running background jobs.
+ */
+
+
+static int _lmThreadPool_worker(void *data) {
+    lmThreadPool *pool = (lmThreadPool *)data;
+
+    while (true) {
+        SDL_SemWait(pool->job_signal);
+
+        // Drain the queue before quitting so no job is lost
+        lmJob job;
+        if (lmMPMCQueue_pop(pool->jobs, &job)) {
+            job.function(job.user_data);
+            continue;
+        }
+
+        if (__atomic_load_n(&pool->quit, __ATOMIC_ACQUIRE)) break;
+    }
+
+    return 0;
+}
+
+
+lmThreadPool *lmThreadPool_new(size_t thread_count) {
+    lmThreadPool *pool = LM_NEW(lmThreadPool);
+    LM_MEMORY_ASSERT(pool);
+
+    #ifdef LM_WEB
+
+        // Threads are not available without SharedArrayBuffer support
+        thread_count = 0;
+
+    #else
+
+        if (thread_count == 0) {
+            int cpus = SDL_GetCPUCount();
+            thread_count = cpus > 1 ? (size_t)cpus - 1 : 1;
+        }
+
+    #endif
+
+    pool->thread_count = thread_count;
+    pool->quit = false;
+    pool->threads = NULL;
+    pool->job_signal = NULL;
+
+    pool->jobs = lmMPMCQueue_new(sizeof(lmJob), LM_THREAD_POOL_QUEUE_SIZE);
+    LM_MEMORY_ASSERT(pool->jobs);
+
+    if (thread_count > 0) {
+        pool->job_signal = SDL_CreateSemaphore(0);
+        if (!pool->job_signal) LM_ERROR(SDL_GetError());
+
+        pool->threads = LM_MALLOC(sizeof(SDL_Thread *) * thread_count);
+        LM_MEMORY_ASSERT(pool->threads);
+
+        for (size_t i = 0; i < thread_count; i++) {
+            pool->threads[i] = SDL_CreateThread(_lmThreadPool_worker, "lumina_worker", pool);
+            if (!pool->threads[i]) LM_ERROR(SDL_GetError());
+        }
+    }
+
+    return pool;
+}
+
+void lmThreadPool_free(lmThreadPool *pool) {
+    if (!pool) return;
+
+    if (pool->thread_count > 0) {
+        __atomic_store_n(&pool->quit, true, __ATOMIC_RELEASE);
+
+        // Wake every worker up once more to see the quit flag
+        for (size_t i = 0; i < pool->thread_count; i++)
+            SDL_SemPost(pool->job_signal);
+
+        for (size_t i = 0; i < pool->thread_count; i++)
+            SDL_WaitThread(pool->threads[i], NULL);
+
+        SDL_DestroySemaphore(pool->job_signal);
+        LM_FREE(pool->threads);
+    }
+
+    lmMPMCQueue_free(pool->jobs);
+    LM_FREE(pool);
+}
+
+void lmThreadPool_submit(lmThreadPool *pool, lmJobFunction function, void *user_data) {
+    if (pool->thread_count == 0 ||
+        !lmMPMCQueue_push(pool->jobs, &(lmJob){.function=function, .user_data=user_data})
+    ) {
+        function(user_data);
+        return;
+    }
+
+    SDL_SemPost(pool->job_signal);
+}
@@ -8,6 +8,8 @@
 
 */
 
+#define LM_MEMORY_TAG lmMemoryTag_CORE
+
 #include "lumina/core/window.h"
 
 
@@ -55,7 +57,7 @@ void lmWindow_free(lmWindow *window) {
 
     SDL_DestroyWindow(window->sdl_window);
     SDL_DestroyRenderer(window->sdl_renderer);
-    free(window);
+    LM_FREE(window);
 }
 
 const char *lmWindow_get_title(lmWindow *window) {
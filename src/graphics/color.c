@@ -18,72 +18,54 @@
  */
 
 
+/**
+ * @brief Divide by 255 with rounding, exact for x in [0, 65535 - 128].
+ */
+static inline lm_int32 _lm_div255(lm_int32 x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+/**
+ * @brief One RGB channel of an HSV color, n is 5 for red, 3 for green and 1
+ *        for blue.
+ * 
+ * Branchless form of the usual per-sector switch in 8-bit fixed point, so
+ * batches vectorize. Float selects don't, GCC won't if-convert them under
+ * the default -ftrapping-math.
+ * https://en.wikipedia.org/wiki/HSL_and_HSV#HSV_to_RGB_alternative
+ */
+static inline lm_uint8 _lm_hsv_channel(lm_int32 n, lm_int32 h, lm_int32 v, lm_int32 vs) {
+    // Position in the hue circle, 255 per sector
+    lm_int32 k = n * 255 + h;
+    k = k >= 6 * 255 ? k - 6 * 255 : k;
+
+    lm_int32 f = k < 4 * 255 - k ? k : 4 * 255 - k;
+    f = f < 0 ? 0 : f;
+    f = f > 255 ? 255 : f;
+
+    return (lm_uint8)(v - _lm_div255(vs * f));
+}
+
+static inline lmColor _lmColor_from_hsv(lmColor hsv_color) {
+    lm_int32 h = (lm_int32)hsv_color.r * 6;
+    lm_int32 v = hsv_color.b;
+    lm_int32 vs = _lm_div255(v * hsv_color.g);
+
+    return (lmColor){
+        _lm_hsv_channel(5, h, v, vs),
+        _lm_hsv_channel(3, h, v, vs),
+        _lm_hsv_channel(1, h, v, vs),
+        hsv_color.a
+    };
+}
+
+
 lmColor lmColor_from_hsv(lmColor hsv_color) {
-    // https://stackoverflow.com/a/6930407
-
-    float h = (float)hsv_color.r * (360.0 / 255.0);
-    float s = (float)hsv_color.g / 255.0;
-    float v = (float)hsv_color.b / 255.0;
-
-    float hh, p, q, t, ff;
-    long i;
-    lmColor out;
-    out.a = hsv_color.a;
-
-    if (s <= 0.0) {
-        out.r = v * 255;
-        out.g = v * 255;
-        out.b = v * 255;
-        return out;
-    }
-
-    hh = h;
-    if(hh >= 360.0) hh = 0.0;
-    hh /= 60.0;
-    i = (long)hh;
-    ff = hh - i;
-    p = v * (1.0 - s);
-    q = v * (1.0 - (s * ff));
-    t = v * (1.0 - (s * (1.0 - ff)));
-
-    switch(i) {
-        case 0:
-            out.r = v * 255;
-            out.g = t * 255;
-            out.b = p * 255;
-            break;
-
-        case 1:
-            out.r = q * 255;
-            out.g = v * 255;
-            out.b = p * 255;
-            break;
-
-        case 2:
-            out.r = p * 255;
-            out.g = v * 255;
-            out.b = t * 255;
-            break;
-
-        case 3:
-            out.r = p * 255;
-            out.g = q * 255;
-            out.b = v * 255;
-            break;
-
-        case 4:
-            out.r = t * 255;
-            out.g = p * 255;
-            out.b = v * 255;
-            break;
-            
-        case 5:
-        default:
-            out.r = v * 255;
-            out.g = p * 255;
-            out.b = q * 255;
-            break;
-    }
-
-    return out; 
-}
\ No newline at end of file
+    return _lmColor_from_hsv(hsv_color);
+}
+
+void lmColor_from_hsv_batch(const lmColor *hsv_colors, lmColor *out, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        out[i] = _lmColor_from_hsv(hsv_colors[i]);
+}
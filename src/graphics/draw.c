@@ -8,6 +8,8 @@
 
 */
 
+#define LM_MEMORY_TAG lmMemoryTag_GRAPHICS
+
 #include "lumina/graphics/draw.h"
 #include "lumina/core/game.h"
 
@@ -100,7 +102,8 @@ void lm_fill_polygon(lmGame *game, lmVector2 vertices[], size_t vertices_len) {
     SDL_Renderer *renderer = game->window->sdl_renderer;
 
     size_t triangles = 3 * vertices_len - 6;
-    SDL_Vertex *sdl_vertices = (SDL_Vertex *)malloc(sizeof(SDL_Vertex) * vertices_len);
+    SDL_Vertex *sdl_vertices = (SDL_Vertex *)lmFrameArena_alloc(game->frame_arena, sizeof(SDL_Vertex) * vertices_len);
+    if (!sdl_vertices) return;
 
     SDL_Color color;
     SDL_GetRenderDrawColor(renderer, &color.r, &color.g, &color.b, &color.a);
@@ -118,7 +121,8 @@ void lm_fill_polygon(lmGame *game, lmVector2 vertices[], size_t vertices_len) {
     // Cast the array size to uint32_t so the compiler doesn't complain
     // about maximum object size
     // A polygon should have that many indices anyway
-    int *indices = (int *)malloc((uint32_t)(sizeof(int) * triangles));
+    int *indices = (int *)lmFrameArena_alloc(game->frame_arena, (uint32_t)(sizeof(int) * triangles));
+    if (!indices) return;
 
     // Triangulate the polygon
     size_t j = 2;
@@ -130,7 +134,4 @@ void lm_fill_polygon(lmGame *game, lmVector2 vertices[], size_t vertices_len) {
     }
 
     SDL_RenderGeometry(renderer, NULL, sdl_vertices, vertices_len, indices, triangles);
-
-    free(sdl_vertices);
-    free(indices);
 }
\ No newline at end of file
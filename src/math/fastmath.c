@@ -0,0 +1,46 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#include "lumina/math/fastmath.h"
+#include "lumina/math/constants.h"
+
+
+/**
+ * @file math/fastmath.c
+ * 
+ * @brief Approximate math functions for hot paths.
+ */
+
+
+lmRotationTable *lmRotationTable_new(size_t steps) {
+    lmRotationTable *table = LM_NEW(lmRotationTable);
+    LM_MEMORY_ASSERT(table);
+
+    table->steps = steps;
+    table->steps_per_radian = (float)((double)steps / LM_TAU);
+
+    table->rotations = LM_MALLOC(sizeof(lmVector2) * steps);
+    LM_MEMORY_ASSERT(table->rotations);
+
+    // Built once, so use the exact functions
+    for (size_t i = 0; i < steps; i++) {
+        double angle = (double)i * LM_TAU / (double)steps;
+        table->rotations[i] = LM_VEC2((float)cos(angle), (float)sin(angle));
+    }
+
+    return table;
+}
+
+void lmRotationTable_free(lmRotationTable *table) {
+    if (!table) return;
+
+    LM_FREE(table->rotations);
+    LM_FREE(table);
+}
@@ -0,0 +1,400 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#include <float.h>
+#include "lumina/math/vector_batch.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+    #define _LM_BATCH_SSE2
+#endif
+
+// AVX2 kernels are compiled with a target attribute and only picked if the
+// CPU has it, so the build doesn't need -mavx2.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    #include <immintrin.h>
+    #define _LM_BATCH_AVX2
+#endif
+
+// Only AArch64 NEON has vector division and square root
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+    #define _LM_BATCH_NEON
+#endif
+
+
+/**
+ * @file math/vector_batch.c
+ * 
+ * @brief 2D vector math over many vectors at once.
+ */
+
+
+static inline lmVector2SoA _lm_soa_offset(lmVector2SoA a, size_t i) {
+    return (lmVector2SoA){a.x + i, a.y + i};
+}
+
+
+/*
+    Scalar kernels, used as the fallback and for the tails of the SIMD ones.
+*/
+
+static void _lm_add_scalar(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out.x[i] = a.x[i] + b.x[i];
+        out.y[i] = a.y[i] + b.y[i];
+    }
+}
+
+static void _lm_add_scaled_scalar(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, float s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out.x[i] = a.x[i] + b.x[i] * s;
+        out.y[i] = a.y[i] + b.y[i] * s;
+    }
+}
+
+static void _lm_scale_scalar(lmVector2SoA out, lmVector2SoA a, float s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out.x[i] = a.x[i] * s;
+        out.y[i] = a.y[i] * s;
+    }
+}
+
+static void _lm_rotate_scalar(lmVector2SoA out, lmVector2SoA a, float c, float s, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        float x = a.x[i], y = a.y[i];
+        out.x[i] = x * c - y * s;
+        out.y[i] = x * s + y * c;
+    }
+}
+
+static void _lm_rotate_each_scalar(
+    lmVector2SoA out,
+    lmVector2SoA a,
+    const float *cos,
+    const float *sin,
+    size_t n
+) {
+    for (size_t i = 0; i < n; i++) {
+        float x = a.x[i], y = a.y[i];
+        out.x[i] = x * cos[i] - y * sin[i];
+        out.y[i] = x * sin[i] + y * cos[i];
+    }
+}
+
+static void _lm_normalize_scalar(lmVector2SoA out, lmVector2SoA a, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        float x = a.x[i], y = a.y[i];
+        // Zero vectors divide by FLT_MIN and stay zero, same as the SIMD kernels
+        float len = fmaxf(sqrtf(x * x + y * y), FLT_MIN);
+        out.x[i] = x / len;
+        out.y[i] = y / len;
+    }
+}
+
+static void _lm_dot_scalar(float *out, lmVector2SoA a, lmVector2SoA b, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        out[i] = a.x[i] * b.x[i] + a.y[i] * b.y[i];
+}
+
+static void _lm_length_scalar(float *out, lmVector2SoA a, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        out[i] = sqrtf(a.x[i] * a.x[i] + a.y[i] * a.y[i]);
+}
+
+static void _lm_lerp_scalar(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, float t, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out.x[i] = a.x[i] + (b.x[i] - a.x[i]) * t;
+        out.y[i] = a.y[i] + (b.y[i] - a.y[i]) * t;
+    }
+}
+
+static void _lm_aabb_scalar(
+    lmVector2SoA min,
+    lmVector2SoA max,
+    lmVector2SoA center,
+    lmVector2SoA half_size,
+    const float *cos,
+    const float *sin,
+    size_t n
+) {
+    for (size_t i = 0; i < n; i++) {
+        float c = fabsf(cos[i]), s = fabsf(sin[i]);
+        float ex = c * half_size.x[i] + s * half_size.y[i];
+        float ey = s * half_size.x[i] + c * half_size.y[i];
+        min.x[i] = center.x[i] - ex;
+        min.y[i] = center.y[i] - ey;
+        max.x[i] = center.x[i] + ex;
+        max.y[i] = center.y[i] + ey;
+    }
+}
+
+static void _lm_bounds_scalar(lmVector2SoA a, size_t n, lmVector2 *min, lmVector2 *max) {
+    if (n == 0) {
+        *min = lmVector2_zero;
+        *max = lmVector2_zero;
+        return;
+    }
+
+    *min = LM_VEC2(a.x[0], a.y[0]);
+    *max = *min;
+    for (size_t i = 1; i < n; i++) {
+        min->x = fminf(min->x, a.x[i]);
+        min->y = fminf(min->y, a.y[i]);
+        max->x = fmaxf(max->x, a.x[i]);
+        max->y = fmaxf(max->y, a.y[i]);
+    }
+}
+
+
+#ifdef _LM_BATCH_SSE2
+
+    #define _LM_KERNEL(name) _lm_##name##_sse2
+    #define _LM_TARGET
+    #define _LM_VF __m128
+    #define _LM_W 4
+    #define _LM_LOAD(p) _mm_loadu_ps(p)
+    #define _LM_STORE(p, v) _mm_storeu_ps(p, v)
+    #define _LM_SET1(f) _mm_set1_ps(f)
+    #define _LM_ADD(a, b) _mm_add_ps(a, b)
+    #define _LM_SUB(a, b) _mm_sub_ps(a, b)
+    #define _LM_MUL(a, b) _mm_mul_ps(a, b)
+    #define _LM_DIV(a, b) _mm_div_ps(a, b)
+    #define _LM_MIN(a, b) _mm_min_ps(a, b)
+    #define _LM_MAX(a, b) _mm_max_ps(a, b)
+    #define _LM_SQRT(v) _mm_sqrt_ps(v)
+    #define _LM_ABS(v) _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)))
+
+    #include "vector_batch_kernels.h"
+
+    #undef _LM_KERNEL
+    #undef _LM_TARGET
+    #undef _LM_VF
+    #undef _LM_W
+    #undef _LM_LOAD
+    #undef _LM_STORE
+    #undef _LM_SET1
+    #undef _LM_ADD
+    #undef _LM_SUB
+    #undef _LM_MUL
+    #undef _LM_DIV
+    #undef _LM_MIN
+    #undef _LM_MAX
+    #undef _LM_SQRT
+    #undef _LM_ABS
+
+#endif
+
+#ifdef _LM_BATCH_AVX2
+
+    #define _LM_KERNEL(name) _lm_##name##_avx2
+    #define _LM_TARGET __attribute__((target("avx2")))
+    #define _LM_VF __m256
+    #define _LM_W 8
+    #define _LM_LOAD(p) _mm256_loadu_ps(p)
+    #define _LM_STORE(p, v) _mm256_storeu_ps(p, v)
+    #define _LM_SET1(f) _mm256_set1_ps(f)
+    #define _LM_ADD(a, b) _mm256_add_ps(a, b)
+    #define _LM_SUB(a, b) _mm256_sub_ps(a, b)
+    #define _LM_MUL(a, b) _mm256_mul_ps(a, b)
+    #define _LM_DIV(a, b) _mm256_div_ps(a, b)
+    #define _LM_MIN(a, b) _mm256_min_ps(a, b)
+    #define _LM_MAX(a, b) _mm256_max_ps(a, b)
+    #define _LM_SQRT(v) _mm256_sqrt_ps(v)
+    #define _LM_ABS(v) _mm256_and_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF)))
+
+    #include "vector_batch_kernels.h"
+
+    #undef _LM_KERNEL
+    #undef _LM_TARGET
+    #undef _LM_VF
+    #undef _LM_W
+    #undef _LM_LOAD
+    #undef _LM_STORE
+    #undef _LM_SET1
+    #undef _LM_ADD
+    #undef _LM_SUB
+    #undef _LM_MUL
+    #undef _LM_DIV
+    #undef _LM_MIN
+    #undef _LM_MAX
+    #undef _LM_SQRT
+    #undef _LM_ABS
+
+#endif
+
+#ifdef _LM_BATCH_NEON
+
+    #define _LM_KERNEL(name) _lm_##name##_neon
+    #define _LM_TARGET
+    #define _LM_VF float32x4_t
+    #define _LM_W 4
+    #define _LM_LOAD(p) vld1q_f32(p)
+    #define _LM_STORE(p, v) vst1q_f32(p, v)
+    #define _LM_SET1(f) vdupq_n_f32(f)
+    #define _LM_ADD(a, b) vaddq_f32(a, b)
+    #define _LM_SUB(a, b) vsubq_f32(a, b)
+    #define _LM_MUL(a, b) vmulq_f32(a, b)
+    #define _LM_DIV(a, b) vdivq_f32(a, b)
+    #define _LM_MIN(a, b) vminq_f32(a, b)
+    #define _LM_MAX(a, b) vmaxq_f32(a, b)
+    #define _LM_SQRT(v) vsqrtq_f32(v)
+    #define _LM_ABS(v) vabsq_f32(v)
+
+    #include "vector_batch_kernels.h"
+
+    #undef _LM_KERNEL
+    #undef _LM_TARGET
+    #undef _LM_VF
+    #undef _LM_W
+    #undef _LM_LOAD
+    #undef _LM_STORE
+    #undef _LM_SET1
+    #undef _LM_ADD
+    #undef _LM_SUB
+    #undef _LM_MUL
+    #undef _LM_DIV
+    #undef _LM_MIN
+    #undef _LM_MAX
+    #undef _LM_SQRT
+    #undef _LM_ABS
+
+#endif
+
+
+/*
+    Runtime dispatch
+*/
+
+typedef struct {
+    const char *isa;
+    void (*add)(lmVector2SoA, lmVector2SoA, lmVector2SoA, size_t);
+    void (*add_scaled)(lmVector2SoA, lmVector2SoA, lmVector2SoA, float, size_t);
+    void (*scale)(lmVector2SoA, lmVector2SoA, float, size_t);
+    void (*rotate)(lmVector2SoA, lmVector2SoA, float, float, size_t);
+    void (*rotate_each)(lmVector2SoA, lmVector2SoA, const float *, const float *, size_t);
+    void (*normalize)(lmVector2SoA, lmVector2SoA, size_t);
+    void (*dot)(float *, lmVector2SoA, lmVector2SoA, size_t);
+    void (*length)(float *, lmVector2SoA, size_t);
+    void (*lerp)(lmVector2SoA, lmVector2SoA, lmVector2SoA, float, size_t);
+    void (*aabb)(lmVector2SoA, lmVector2SoA, lmVector2SoA, lmVector2SoA, const float *, const float *, size_t);
+    void (*bounds)(lmVector2SoA, size_t, lmVector2 *, lmVector2 *);
+} _lmVectorBatchKernels;
+
+#define _LM_KERNEL_TABLE(name, suffix) {                                        \
+    name,                                                                       \
+    _lm_add_##suffix, _lm_add_scaled_##suffix, _lm_scale_##suffix,              \
+    _lm_rotate_##suffix, _lm_rotate_each_##suffix, _lm_normalize_##suffix,      \
+    _lm_dot_##suffix, _lm_length_##suffix, _lm_lerp_##suffix,                   \
+    _lm_aabb_##suffix, _lm_bounds_##suffix                                      \
+}
+
+static const _lmVectorBatchKernels _lm_scalar_kernels = _LM_KERNEL_TABLE("scalar", scalar);
+
+#ifdef _LM_BATCH_SSE2
+    static const _lmVectorBatchKernels _lm_sse2_kernels = _LM_KERNEL_TABLE("sse2", sse2);
+#endif
+
+#ifdef _LM_BATCH_AVX2
+    static const _lmVectorBatchKernels _lm_avx2_kernels = _LM_KERNEL_TABLE("avx2", avx2);
+#endif
+
+#ifdef _LM_BATCH_NEON
+    static const _lmVectorBatchKernels _lm_neon_kernels = _LM_KERNEL_TABLE("neon", neon);
+#endif
+
+static const _lmVectorBatchKernels *_lm_kernels = NULL;
+
+static const _lmVectorBatchKernels *_lm_get_kernels() {
+    const _lmVectorBatchKernels *kernels = __atomic_load_n(&_lm_kernels, __ATOMIC_ACQUIRE);
+    if (kernels) return kernels;
+
+    // Racing threads all pick the same table, so no lock needed
+    kernels = &_lm_scalar_kernels;
+
+    #ifdef _LM_BATCH_SSE2
+        if (SDL_HasSSE2()) kernels = &_lm_sse2_kernels;
+    #endif
+
+    #ifdef _LM_BATCH_AVX2
+        if (SDL_HasAVX2()) kernels = &_lm_avx2_kernels;
+    #endif
+
+    #ifdef _LM_BATCH_NEON
+        if (SDL_HasNEON()) kernels = &_lm_neon_kernels;
+    #endif
+
+    __atomic_store_n(&_lm_kernels, kernels, __ATOMIC_RELEASE);
+
+    return kernels;
+}
+
+
+const char *lm_vector_batch_isa() {
+    return _lm_get_kernels()->isa;
+}
+
+void lmVector2SoA_add(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, size_t n) {
+    _lm_get_kernels()->add(out, a, b, n);
+}
+
+void lmVector2SoA_add_scaled(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, float s, size_t n) {
+    _lm_get_kernels()->add_scaled(out, a, b, s, n);
+}
+
+void lmVector2SoA_scale(lmVector2SoA out, lmVector2SoA a, float s, size_t n) {
+    _lm_get_kernels()->scale(out, a, s, n);
+}
+
+void lmVector2SoA_rotate(lmVector2SoA out, lmVector2SoA a, float angle, size_t n) {
+    _lm_get_kernels()->rotate(out, a, cosf(angle), sinf(angle), n);
+}
+
+void lmVector2SoA_rotate_each(
+    lmVector2SoA out,
+    lmVector2SoA a,
+    const float *cos,
+    const float *sin,
+    size_t n
+) {
+    _lm_get_kernels()->rotate_each(out, a, cos, sin, n);
+}
+
+void lmVector2SoA_normalize(lmVector2SoA out, lmVector2SoA a, size_t n) {
+    _lm_get_kernels()->normalize(out, a, n);
+}
+
+void lmVector2SoA_dot(float *out, lmVector2SoA a, lmVector2SoA b, size_t n) {
+    _lm_get_kernels()->dot(out, a, b, n);
+}
+
+void lmVector2SoA_length(float *out, lmVector2SoA a, size_t n) {
+    _lm_get_kernels()->length(out, a, n);
+}
+
+void lmVector2SoA_lerp(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, float t, size_t n) {
+    _lm_get_kernels()->lerp(out, a, b, t, n);
+}
+
+void lmVector2SoA_aabb(
+    lmVector2SoA min,
+    lmVector2SoA max,
+    lmVector2SoA center,
+    lmVector2SoA half_size,
+    const float *cos,
+    const float *sin,
+    size_t n
+) {
+    _lm_get_kernels()->aabb(min, max, center, half_size, cos, sin, n);
+}
+
+void lmVector2SoA_bounds(lmVector2SoA a, size_t n, lmVector2 *min, lmVector2 *max) {
+    _lm_get_kernels()->bounds(a, n, min, max);
+}
@@ -0,0 +1,196 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+/**
+ * @file math/vector_batch_kernels.h
+ * 
+ * @brief Batch vector kernels, included once per instruction set by
+ *        vector_batch.c.
+ * 
+ * The includer defines:
+ *  _LM_KERNEL(name)  Name of the kernel for this instruction set
+ *  _LM_TARGET        Function attributes enabling the instruction set
+ *  _LM_VF            Vector of floats type
+ *  _LM_W             Number of floats in _LM_VF
+ *  _LM_LOAD(p), _LM_STORE(p, v), _LM_SET1(f)
+ *  _LM_ADD, _LM_SUB, _LM_MUL, _LM_DIV, _LM_MIN, _LM_MAX (a, b)
+ *  _LM_SQRT(v), _LM_ABS(v)
+ * 
+ * Each kernel handles whole vectors and leaves the tail to the scalar one.
+ */
+
+
+_LM_TARGET static void _LM_KERNEL(add)(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, size_t n) {
+    size_t i = 0;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_STORE(out.x + i, _LM_ADD(_LM_LOAD(a.x + i), _LM_LOAD(b.x + i)));
+        _LM_STORE(out.y + i, _LM_ADD(_LM_LOAD(a.y + i), _LM_LOAD(b.y + i)));
+    }
+    _lm_add_scalar(_lm_soa_offset(out, i), _lm_soa_offset(a, i), _lm_soa_offset(b, i), n - i);
+}
+
+_LM_TARGET static void _LM_KERNEL(add_scaled)(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, float s, size_t n) {
+    _LM_VF vs = _LM_SET1(s);
+    size_t i = 0;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_STORE(out.x + i, _LM_ADD(_LM_LOAD(a.x + i), _LM_MUL(_LM_LOAD(b.x + i), vs)));
+        _LM_STORE(out.y + i, _LM_ADD(_LM_LOAD(a.y + i), _LM_MUL(_LM_LOAD(b.y + i), vs)));
+    }
+    _lm_add_scaled_scalar(_lm_soa_offset(out, i), _lm_soa_offset(a, i), _lm_soa_offset(b, i), s, n - i);
+}
+
+_LM_TARGET static void _LM_KERNEL(scale)(lmVector2SoA out, lmVector2SoA a, float s, size_t n) {
+    _LM_VF vs = _LM_SET1(s);
+    size_t i = 0;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_STORE(out.x + i, _LM_MUL(_LM_LOAD(a.x + i), vs));
+        _LM_STORE(out.y + i, _LM_MUL(_LM_LOAD(a.y + i), vs));
+    }
+    _lm_scale_scalar(_lm_soa_offset(out, i), _lm_soa_offset(a, i), s, n - i);
+}
+
+_LM_TARGET static void _LM_KERNEL(rotate_each)(
+    lmVector2SoA out,
+    lmVector2SoA a,
+    const float *cos,
+    const float *sin,
+    size_t n
+) {
+    size_t i = 0;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_VF x = _LM_LOAD(a.x + i), y = _LM_LOAD(a.y + i);
+        _LM_VF c = _LM_LOAD(cos + i), s = _LM_LOAD(sin + i);
+        _LM_STORE(out.x + i, _LM_SUB(_LM_MUL(x, c), _LM_MUL(y, s)));
+        _LM_STORE(out.y + i, _LM_ADD(_LM_MUL(x, s), _LM_MUL(y, c)));
+    }
+    _lm_rotate_each_scalar(_lm_soa_offset(out, i), _lm_soa_offset(a, i), cos + i, sin + i, n - i);
+}
+
+_LM_TARGET static void _LM_KERNEL(rotate)(lmVector2SoA out, lmVector2SoA a, float c, float s, size_t n) {
+    _LM_VF vc = _LM_SET1(c), vs = _LM_SET1(s);
+    size_t i = 0;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_VF x = _LM_LOAD(a.x + i), y = _LM_LOAD(a.y + i);
+        _LM_STORE(out.x + i, _LM_SUB(_LM_MUL(x, vc), _LM_MUL(y, vs)));
+        _LM_STORE(out.y + i, _LM_ADD(_LM_MUL(x, vs), _LM_MUL(y, vc)));
+    }
+    _lm_rotate_scalar(_lm_soa_offset(out, i), _lm_soa_offset(a, i), c, s, n - i);
+}
+
+_LM_TARGET static void _LM_KERNEL(normalize)(lmVector2SoA out, lmVector2SoA a, size_t n) {
+    _LM_VF tiny = _LM_SET1(FLT_MIN);
+    size_t i = 0;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_VF x = _LM_LOAD(a.x + i), y = _LM_LOAD(a.y + i);
+        _LM_VF len = _LM_MAX(_LM_SQRT(_LM_ADD(_LM_MUL(x, x), _LM_MUL(y, y))), tiny);
+        _LM_STORE(out.x + i, _LM_DIV(x, len));
+        _LM_STORE(out.y + i, _LM_DIV(y, len));
+    }
+    _lm_normalize_scalar(_lm_soa_offset(out, i), _lm_soa_offset(a, i), n - i);
+}
+
+_LM_TARGET static void _LM_KERNEL(dot)(float *out, lmVector2SoA a, lmVector2SoA b, size_t n) {
+    size_t i = 0;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_VF x = _LM_MUL(_LM_LOAD(a.x + i), _LM_LOAD(b.x + i));
+        _LM_VF y = _LM_MUL(_LM_LOAD(a.y + i), _LM_LOAD(b.y + i));
+        _LM_STORE(out + i, _LM_ADD(x, y));
+    }
+    _lm_dot_scalar(out + i, _lm_soa_offset(a, i), _lm_soa_offset(b, i), n - i);
+}
+
+_LM_TARGET static void _LM_KERNEL(length)(float *out, lmVector2SoA a, size_t n) {
+    size_t i = 0;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_VF x = _LM_LOAD(a.x + i), y = _LM_LOAD(a.y + i);
+        _LM_STORE(out + i, _LM_SQRT(_LM_ADD(_LM_MUL(x, x), _LM_MUL(y, y))));
+    }
+    _lm_length_scalar(out + i, _lm_soa_offset(a, i), n - i);
+}
+
+_LM_TARGET static void _LM_KERNEL(lerp)(lmVector2SoA out, lmVector2SoA a, lmVector2SoA b, float t, size_t n) {
+    _LM_VF vt = _LM_SET1(t);
+    size_t i = 0;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_VF ax = _LM_LOAD(a.x + i), ay = _LM_LOAD(a.y + i);
+        _LM_STORE(out.x + i, _LM_ADD(ax, _LM_MUL(_LM_SUB(_LM_LOAD(b.x + i), ax), vt)));
+        _LM_STORE(out.y + i, _LM_ADD(ay, _LM_MUL(_LM_SUB(_LM_LOAD(b.y + i), ay), vt)));
+    }
+    _lm_lerp_scalar(_lm_soa_offset(out, i), _lm_soa_offset(a, i), _lm_soa_offset(b, i), t, n - i);
+}
+
+_LM_TARGET static void _LM_KERNEL(aabb)(
+    lmVector2SoA min,
+    lmVector2SoA max,
+    lmVector2SoA center,
+    lmVector2SoA half_size,
+    const float *cos,
+    const float *sin,
+    size_t n
+) {
+    size_t i = 0;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_VF c = _LM_ABS(_LM_LOAD(cos + i)), s = _LM_ABS(_LM_LOAD(sin + i));
+        _LM_VF hw = _LM_LOAD(half_size.x + i), hh = _LM_LOAD(half_size.y + i);
+        _LM_VF ex = _LM_ADD(_LM_MUL(c, hw), _LM_MUL(s, hh));
+        _LM_VF ey = _LM_ADD(_LM_MUL(s, hw), _LM_MUL(c, hh));
+        _LM_VF cx = _LM_LOAD(center.x + i), cy = _LM_LOAD(center.y + i);
+        _LM_STORE(min.x + i, _LM_SUB(cx, ex));
+        _LM_STORE(min.y + i, _LM_SUB(cy, ey));
+        _LM_STORE(max.x + i, _LM_ADD(cx, ex));
+        _LM_STORE(max.y + i, _LM_ADD(cy, ey));
+    }
+    _lm_aabb_scalar(
+        _lm_soa_offset(min, i), _lm_soa_offset(max, i),
+        _lm_soa_offset(center, i), _lm_soa_offset(half_size, i),
+        cos + i, sin + i, n - i
+    );
+}
+
+_LM_TARGET static void _LM_KERNEL(bounds)(lmVector2SoA a, size_t n, lmVector2 *min, lmVector2 *max) {
+    if (n < _LM_W) {
+        _lm_bounds_scalar(a, n, min, max);
+        return;
+    }
+
+    _LM_VF min_x = _LM_LOAD(a.x), min_y = _LM_LOAD(a.y);
+    _LM_VF max_x = min_x, max_y = min_y;
+
+    size_t i = _LM_W;
+    for (; i + _LM_W <= n; i += _LM_W) {
+        _LM_VF x = _LM_LOAD(a.x + i), y = _LM_LOAD(a.y + i);
+        min_x = _LM_MIN(min_x, x);
+        min_y = _LM_MIN(min_y, y);
+        max_x = _LM_MAX(max_x, x);
+        max_y = _LM_MAX(max_y, y);
+    }
+
+    // Reduce the lanes and the tail
+    float lanes[4][_LM_W];
+    _LM_STORE(lanes[0], min_x);
+    _LM_STORE(lanes[1], min_y);
+    _LM_STORE(lanes[2], max_x);
+    _LM_STORE(lanes[3], max_y);
+
+    *min = LM_VEC2(lanes[0][0], lanes[1][0]);
+    *max = LM_VEC2(lanes[2][0], lanes[3][0]);
+    for (size_t j = 1; j < _LM_W; j++) {
+        min->x = fminf(min->x, lanes[0][j]);
+        min->y = fminf(min->y, lanes[1][j]);
+        max->x = fmaxf(max->x, lanes[2][j]);
+        max->y = fmaxf(max->y, lanes[3][j]);
+    }
+    for (; i < n; i++) {
+        min->x = fminf(min->x, a.x[i]);
+        min->y = fminf(min->y, a.y[i]);
+        max->x = fmaxf(max->x, a.x[i]);
+        max->y = fmaxf(max->y, a.y[i]);
+    }
+}
@@ -18,19 +18,48 @@
  */
 
 
+static void _lmFont_setup(TTF_Font *ttf, int style) {
+    TTF_SetFontStyle(ttf, style);
+    TTF_SetFontOutline(ttf, 0);
+    TTF_SetFontKerning(ttf, 1);
+    TTF_SetFontHinting(ttf, TTF_HINTING_NORMAL);
+}
+
+
 lmFont lmFont_load(const char *filepath, lm_uint32 size) {
     lmFont font;
 
     font.ttf = TTF_OpenFont(filepath, size);
     if (!font.ttf) LM_ERROR(TTF_GetError());
 
-    TTF_SetFontStyle(font.ttf, TTF_STYLE_NORMAL);
-    TTF_SetFontOutline(font.ttf, 0);
-    TTF_SetFontKerning(font.ttf, 1);
-    TTF_SetFontHinting(font.ttf, TTF_HINTING_NORMAL);
+    _lmFont_setup(font.ttf, TTF_STYLE_NORMAL);
 
     font.filepath = filepath;
+    font.id = lm_string_id(filepath);
+    font.size = size;
+    font.style = TTF_STYLE_NORMAL;
+
+    return font;
+}
+
+lmFont lmFont_load_from_memory(
+    const char *filepath,
+    const void *data,
+    size_t data_size,
+    lm_uint32 size,
+    int style
+) {
+    lmFont font;
+
+    // Only the RWops is freed on close, the data stays with the caller
+    SDL_RWops *rw = SDL_RWFromConstMem(data, (int)data_size);
+    font.ttf = rw ? TTF_OpenFontRW(rw, 1, size) : NULL;
+    if (font.ttf) _lmFont_setup(font.ttf, style);
+
+    font.filepath = (char *)filepath;
+    font.id = lm_string_id(filepath);
     font.size = size;
+    font.style = style;
 
     return font;
-}
\ No newline at end of file
+}
@@ -0,0 +1,300 @@
+/*
+
+  This file is a part of the Lumina Game Engine
+  project and distributed under the MIT license.
+
+  Copyright © Kadir Aksoy
+  https://github.com/kadir014/lumina
+
+*/
+
+#define LM_MEMORY_TAG lmMemoryTag_RESOURCE
+
+#include "lumina/resource/pack.h"
+#include "lumina/math/hash.h"
+
+#if LM_PLATFORM == LM_PLATFORM_WINDOWS
+    #include <windows.h>
+#elif LM_PLATFORM != LM_PLATFORM_WEB
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+
+/**
+ * @file resource/pack.c
+ * 
+ * @brief Packed asset archives.
+ */
+
+
+/**
+ * @brief Decompress LZ4 block. Returns `false` if the input is corrupted.
+ * 
+ * Every read and write is bounds checked since the data comes from disk.
+ */
+static bool _lm_lz4_decompress(
+    const lm_uint8 *src,
+    size_t src_size,
+    lm_uint8 *dst,
+    size_t dst_size
+) {
+    const lm_uint8 *ip = src;
+    const lm_uint8 *iend = src + src_size;
+    lm_uint8 *op = dst;
+    lm_uint8 *oend = dst + dst_size;
+
+    while (ip < iend) {
+        lm_uint8 token = *ip++;
+
+        // Literals
+        size_t length = token >> 4;
+        if (length == 15) {
+            lm_uint8 byte;
+            do {
+                if (ip >= iend) return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+        }
+
+        if (length > (size_t)(iend - ip) || length > (size_t)(oend - op)) return false;
+        memcpy(op, ip, length);
+        ip += length;
+        op += length;
+
+        // The last sequence has no match
+        if (ip == iend) break;
+
+        // Match
+        if (iend - ip < 2) return false;
+        size_t offset = ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) return false;
+
+        length = (token & 15) + 4;
+        if ((token & 15) == 15) {
+            lm_uint8 byte;
+            do {
+                if (ip >= iend) return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+        }
+
+        if (length > (size_t)(oend - op)) return false;
+
+        // Matches can overlap their own output, so copy byte by byte then
+        const lm_uint8 *match = op - offset;
+        if (offset >= length) {
+            memcpy(op, match, length);
+            op += length;
+        }
+        else {
+            while (length--) *op++ = *match++;
+        }
+    }
+
+    return op == oend;
+}
+
+
+static bool _lmPack_map(lmPack *pack, const char *filepath) {
+    #if LM_PLATFORM == LM_PLATFORM_WEB
+
+        // No mmap on web, the preloaded file system is in memory anyway
+        size_t size;
+        void *data = SDL_LoadFile(filepath, &size);
+        if (!data) return false;
+
+        pack->data = data;
+        pack->size = size;
+        pack->mapping = NULL;
+
+        return true;
+
+    #elif LM_PLATFORM == LM_PLATFORM_WINDOWS
+
+        HANDLE file = CreateFileA(
+            filepath, GENERIC_READ, FILE_SHARE_READ, NULL,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL
+        );
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        // The mapping keeps the file open
+        CloseHandle(file);
+        if (!mapping) return false;
+
+        void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!data) {
+            CloseHandle(mapping);
+            return false;
+        }
+
+        pack->data = data;
+        pack->size = (size_t)size.QuadPart;
+        pack->mapping = mapping;
+
+        return true;
+
+    #else
+
+        int fd = open(filepath, O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return false;
+        }
+
+        void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The mapping keeps the file open
+        close(fd);
+        if (data == MAP_FAILED) return false;
+
+        pack->data = data;
+        pack->size = (size_t)st.st_size;
+        pack->mapping = NULL;
+
+        return true;
+
+    #endif
+}
+
+static void _lmPack_unmap(lmPack *pack) {
+    #if LM_PLATFORM == LM_PLATFORM_WEB
+
+        SDL_free((void *)pack->data);
+
+    #elif LM_PLATFORM == LM_PLATFORM_WINDOWS
+
+        UnmapViewOfFile(pack->data);
+        CloseHandle(pack->mapping);
+
+    #else
+
+        munmap((void *)pack->data, pack->size);
+
+    #endif
+}
+
+
+lmPack *lmPack_open(const char *filepath) {
+    lmPack *pack = LM_NEW(lmPack);
+    if (!pack) return NULL;
+
+    if (!_lmPack_map(pack, filepath)) {
+        LM_FREE(pack);
+        return NULL;
+    }
+
+    // Validate everything the lookups rely on once, here
+    lmPackHeader header;
+    if (pack->size < sizeof(lmPackHeader)) goto invalid;
+    memcpy(&header, pack->data, sizeof(lmPackHeader));
+
+    if (memcmp(header.magic, LM_PACK_MAGIC, 4) != 0) goto invalid;
+    if (header.version != LM_PACK_VERSION) goto invalid;
+    if (header.index_offset % 8 != 0) goto invalid;
+    if (header.index_offset > pack->size) goto invalid;
+    if (header.entry_count > (pack->size - header.index_offset) / sizeof(lmPackEntry)) goto invalid;
+    if (header.strings_offset < header.index_offset + (lm_uint64)header.entry_count * sizeof(lmPackEntry)) goto invalid;
+    if (header.strings_offset > pack->size) goto invalid;
+
+    pack->entries = (const lmPackEntry *)(pack->data + header.index_offset);
+    pack->entry_count = header.entry_count;
+    pack->strings = (const char *)(pack->data + header.strings_offset);
+
+    size_t strings_size = pack->size - header.strings_offset;
+    for (lm_uint32 i = 0; i < pack->entry_count; i++) {
+        const lmPackEntry *entry = &pack->entries[i];
+
+        if ((lm_uint64)entry->path_offset + entry->path_length > strings_size) goto invalid;
+        if (entry->offset > pack->size || entry->size > pack->size - entry->offset) goto invalid;
+        if (entry->compression > lmPackCompression_LZ4) goto invalid;
+    }
+
+    return pack;
+
+invalid:
+    _lmPack_unmap(pack);
+    LM_FREE(pack);
+    return NULL;
+}
+
+void lmPack_close(lmPack *pack) {
+    if (!pack) return;
+
+    _lmPack_unmap(pack);
+    LM_FREE(pack);
+}
+
+const lmPackEntry *lmPack_find(lmPack *pack, const char *path) {
+    lm_uint64 hash = lm_fnv1a(path);
+    size_t path_length = strlen(path);
+
+    // Binary search for the first entry with the hash
+    size_t low = 0;
+    size_t high = pack->entry_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (pack->entries[mid].path_hash < hash) low = mid + 1;
+        else high = mid;
+    }
+
+    for (size_t i = low; i < pack->entry_count && pack->entries[i].path_hash == hash; i++) {
+        const lmPackEntry *entry = &pack->entries[i];
+
+        if (entry->path_length == path_length &&
+            memcmp(pack->strings + entry->path_offset, path, path_length) == 0)
+            return entry;
+    }
+
+    return NULL;
+}
+
+bool lmPack_read(lmPack *pack, const char *path, lmPackBlob *blob) {
+    const lmPackEntry *entry = lmPack_find(pack, path);
+    if (!entry) return false;
+
+    const lm_uint8 *data = pack->data + entry->offset;
+
+    if (entry->compression == lmPackCompression_NONE) {
+        blob->data = data;
+        blob->size = entry->size;
+        blob->owned = NULL;
+        return true;
+    }
+
+    // SDL_malloc so fonts can take ownership of it
+    void *decompressed = SDL_malloc(entry->original_size ? entry->original_size : 1);
+    if (!decompressed) return false;
+
+    if (!_lm_lz4_decompress(data, entry->size, decompressed, entry->original_size)) {
+        SDL_free(decompressed);
+        return false;
+    }
+
+    blob->data = decompressed;
+    blob->size = entry->original_size;
+    blob->owned = decompressed;
+
+    return true;
+}
+
+void lmPackBlob_free(lmPackBlob *blob) {
+    SDL_free(blob->owned);
+    blob->data = NULL;
+    blob->size = 0;
+    blob->owned = NULL;
+}
@@ -8,6 +8,8 @@
 
 */
 
+#define LM_MEMORY_TAG lmMemoryTag_RESOURCE
+
 #include "lumina/resource/resource_manager.h"
 #include "lumina/math/hash.h"
 #include "lumina/core/game.h"
@@ -23,16 +25,46 @@
 static lm_uint64 _font_hasher(void *item) {
     lmFont *font = (lmFont *)item;
 
-    // TODO: combine path + size
-    lm_uint64 hash = lm_fnv1a(font->filepath);
+    // IDs are already hashes
+    lm_uint64 hash = lm_hash_combine(font->id, font->size);
+    hash = lm_hash_combine(hash, (lm_uint64)font->style);
 
     return hash;
 }
 
+static lm_uint64 _font_file_hasher(void *item) {
+    return ((lmFontFile *)item)->id;
+}
+
 static lm_uint64 _texture_hasher(void *item) {
     lmTexture *texture = (lmTexture *)item;
 
-    return lm_fnv1a(texture->filepath);
+    return texture->id;
+}
+
+static int _font_compare(void *a, void *b) {
+    lmFont *font_a = (lmFont *)a;
+    lmFont *font_b = (lmFont *)b;
+
+    return font_a->id != font_b->id || font_a->size != font_b->size || font_a->style != font_b->style;
+}
+
+static int _font_file_compare(void *a, void *b) {
+    return ((lmFontFile *)a)->id != ((lmFontFile *)b)->id;
+}
+
+static int _texture_compare(void *a, void *b) {
+    return ((lmTexture *)a)->id != ((lmTexture *)b)->id;
+}
+
+/**
+ * @brief Free handle and whatever it still holds, without unlisting it.
+ */
+static void _lmResourceHandle_free_data(lmResourceHandle *handle) {
+    if (handle->surface) SDL_FreeSurface(handle->surface);
+    SDL_free(handle->file_data);
+    LM_FREE(handle->filepath);
+    LM_FREE(handle);
 }
 
 
@@ -40,16 +72,48 @@ lmResourceManager *lmResourceManager_new() {
     lmResourceManager *resource_manager = LM_NEW(lmResourceManager);
     LM_MEMORY_ASSERT(resource_manager);
 
-    resource_manager->fonts = lmHashMap_new(
-        sizeof(lmFont), 0, _font_hasher
+    resource_manager->fonts = lmConcurrentHashMap_new(
+        sizeof(lmFont), 0, _font_hasher, _font_compare
     );
     LM_MEMORY_ASSERT(resource_manager->fonts);
 
-    resource_manager->textures = lmHashMap_new(
-        sizeof(lmTexture), 0, _texture_hasher
+    resource_manager->font_files = lmHashMap_new(
+        sizeof(lmFontFile), 0, _font_file_hasher, _font_file_compare
+    );
+    LM_MEMORY_ASSERT(resource_manager->font_files);
+
+    resource_manager->textures = lmConcurrentHashMap_new(
+        sizeof(lmTexture), 0, _texture_hasher, _texture_compare
     );
     LM_MEMORY_ASSERT(resource_manager->textures);
 
+    resource_manager->handles = lmArray_new();
+    LM_MEMORY_ASSERT(resource_manager->handles);
+
+    resource_manager->decoded = lmVec_new(sizeof(lmResourceHandle *));
+    LM_MEMORY_ASSERT(resource_manager->decoded);
+
+    resource_manager->decoded_lock = SDL_CreateMutex();
+    LM_MEMORY_ASSERT(resource_manager->decoded_lock);
+
+    resource_manager->uploads = lmVec_new(sizeof(lmResourceHandle *));
+    LM_MEMORY_ASSERT(resource_manager->uploads);
+
+    resource_manager->upload_budget = LM_RESOURCE_UPLOAD_BUDGET;
+
+    resource_manager->texture_budget = 0;
+    resource_manager->texture_bytes = 0;
+    resource_manager->frame = 0;
+    resource_manager->main_thread = SDL_ThreadID();
+
+    resource_manager->pack = NULL;
+
+    resource_manager->retired_packs = lmVec_new(sizeof(lmPack *));
+    LM_MEMORY_ASSERT(resource_manager->retired_packs);
+
+    resource_manager->watcher = NULL;
+    resource_manager->changed_files = NULL;
+
     return resource_manager;
 }
 
@@ -58,19 +122,157 @@ void lmResourceManager_free(lmResourceManager *resource_manager) {
 
     size_t iter = 0;
     void *item;
-    while (lmHashMap_iter(resource_manager->fonts, &iter, &item)) {
+    while (lmConcurrentHashMap_iter(resource_manager->fonts, &iter, &item)) {
         lmFont *font = (lmFont *)item;
         TTF_CloseFont(font->ttf);
     }
 
+    // Font data has to outlive every font using it
     iter = 0;
-    while (lmHashMap_iter(resource_manager->fonts, &iter, &item)) {
+    while (lmHashMap_iter(resource_manager->font_files, &iter, &item)) {
+        lmFontFile *file = (lmFontFile *)item;
+        if (file->owned) SDL_free(file->data);
+    }
+
+    iter = 0;
+    while (lmConcurrentHashMap_iter(resource_manager->textures, &iter, &item)) {
         lmTexture *texture = (lmTexture *)item;
-        SDL_DestroyTexture(texture->sdl_texture);
+        if (texture->sdl_texture) SDL_DestroyTexture(texture->sdl_texture);
+    }
+
+    // Workers are stopped by now, free what never got uploaded
+    for (size_t i = 0; i < resource_manager->handles->size; i++)
+        _lmResourceHandle_free_data(resource_manager->handles->data[i]);
+
+    lmConcurrentHashMap_free(resource_manager->fonts);
+    lmHashMap_free(resource_manager->font_files);
+    lmConcurrentHashMap_free(resource_manager->textures);
+    lmArray_free(resource_manager->handles);
+    lmVec_free(resource_manager->decoded);
+    SDL_DestroyMutex(resource_manager->decoded_lock);
+    lmVec_free(resource_manager->uploads);
+    if (resource_manager->watcher) {
+        lmFileWatcher_free(resource_manager->watcher);
+        lmVec_free(resource_manager->changed_files);
+    }
+
+    // Fonts may still be reading from the mapped packs until closed above
+    lmPack_close(resource_manager->pack);
+    for (size_t i = 0; i < resource_manager->retired_packs->size; i++)
+        lmPack_close(LM_VEC_AT(resource_manager->retired_packs, lmPack *, i));
+    lmVec_free(resource_manager->retired_packs);
+
+    LM_FREE(resource_manager);
+}
+
+void lmResourceManager_collect(lmResourceManager *resource_manager) {
+    lmConcurrentHashMap_collect(resource_manager->fonts);
+    lmConcurrentHashMap_collect(resource_manager->textures);
+}
+
+bool lmResource_mount_pack(lmGame *game, const char *filepath) {
+    lmPack *pack = lmPack_open(filepath);
+    if (!pack) return false;
+
+    lmResourceManager *resource_manager = game->resource_manager;
+
+    if (resource_manager->pack)
+        LM_MEMORY_ASSERT(lmVec_push(resource_manager->retired_packs, &resource_manager->pack));
+
+    // Decode jobs read the pointer from worker threads
+    __atomic_store_n(&resource_manager->pack, pack, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/**
+ * @brief Watch file for hot reloading if enabled. Packed files don't change.
+ */
+static void _lmResource_watch(lmResourceManager *resource_manager, const char *filepath) {
+    if (!resource_manager->watcher) return;
+    if (resource_manager->pack && lmPack_find(resource_manager->pack, filepath)) return;
+
+    lmFileWatcher_add(resource_manager->watcher, filepath);
+}
+
+/**
+ * @brief Load SDL texture from the mounted pack, or the file system if it's not in there.
+ */
+static SDL_Texture *_lmResource_load_sdl_texture(lmGame *game, const char *filepath) {
+    lmPack *pack = game->resource_manager->pack;
+    lmPackBlob blob;
+
+    if (pack && lmPack_read(pack, filepath, &blob)) {
+        SDL_RWops *rw = SDL_RWFromConstMem(blob.data, (int)blob.size);
+        SDL_Texture *sdl_texture = rw ? IMG_LoadTexture_RW(game->window->sdl_renderer, rw, 1) : NULL;
+        lmPackBlob_free(&blob);
+        return sdl_texture;
     }
 
-    lmHashMap_free(resource_manager->fonts);
-    lmHashMap_free(resource_manager->textures);
+    return IMG_LoadTexture(game->window->sdl_renderer, filepath);
+}
+
+void lmResource_enable_hot_reload(lmGame *game) {
+    lmResourceManager *resource_manager = game->resource_manager;
+    if (resource_manager->watcher) return;
+
+    resource_manager->watcher = lmFileWatcher_new();
+    resource_manager->changed_files = lmVec_new(sizeof(const char *));
+    LM_MEMORY_ASSERT(resource_manager->changed_files);
+
+    size_t iter = 0;
+    void *item;
+    while (lmConcurrentHashMap_iter(resource_manager->textures, &iter, &item))
+        _lmResource_watch(resource_manager, ((lmTexture *)item)->filepath);
+
+    iter = 0;
+    while (lmHashMap_iter(resource_manager->font_files, &iter, &item))
+        _lmResource_watch(resource_manager, ((lmFontFile *)item)->filepath);
+}
+
+/**
+ * @brief Get the shared data of a font file, loading it if needed. Returns `NULL` on failure.
+ * 
+ * If data is given it's used instead of reading the file, and freed if the
+ * file was already loaded.
+ */
+static lmFontFile *_lmResource_get_font_file(
+    lmResourceManager *resource_manager,
+    const char *filepath,
+    void *data,
+    size_t data_size
+) {
+    lmStringId id = lm_intern_string(filepath);
+
+    lmFontFile *file = lmHashMap_get(resource_manager->font_files, &(lmFontFile){.id=id});
+    if (file) {
+        SDL_free(data);
+        return file;
+    }
+
+    lmFontFile new_file = {
+        .id=id, .filepath=lm_string_id_lookup(id), .data=data, .size=data_size, .owned=true
+    };
+
+    if (!new_file.data) {
+        lmPackBlob blob;
+
+        // Uncompressed pack entries are used in place
+        if (resource_manager->pack && lmPack_read(resource_manager->pack, filepath, &blob)) {
+            new_file.data = blob.owned ? blob.owned : (void *)blob.data;
+            new_file.size = blob.size;
+            new_file.owned = blob.owned != NULL;
+        }
+        else {
+            new_file.data = SDL_LoadFile(filepath, &new_file.size);
+            if (!new_file.data) return NULL;
+        }
+    }
+
+    lmHashMap_set(resource_manager->font_files, &new_file);
+    _lmResource_watch(resource_manager, new_file.filepath);
+
+    return lmHashMap_get(resource_manager->font_files, &new_file);
 }
 
 void lmResource_load_font(
@@ -78,9 +280,29 @@ void lmResource_load_font(
     char *filepath,
     lm_uint32 size
 ) {
-    lmFont font = lmFont_load(filepath, size);
+    lmResource_load_font_styled(game, filepath, size, TTF_STYLE_NORMAL);
+}
 
-    lmHashMap_set(game->resource_manager->fonts, &font);
+void lmResource_load_font_styled(
+    lmGame *game,
+    char *filepath,
+    lm_uint32 size,
+    int style
+) {
+    lmResourceManager *resource_manager = game->resource_manager;
+
+    if (lmResource_get_font_styled(game, filepath, size, style)) return;
+
+    lmFontFile *file = _lmResource_get_font_file(resource_manager, filepath, NULL, 0);
+    if (!file) LM_ERROR(SDL_GetError());
+
+    // The interned path outlives the caller's
+    lmFont font = lmFont_load_from_memory(
+        (char *)file->filepath, file->data, file->size, size, style
+    );
+    if (!font.ttf) LM_ERROR(TTF_GetError());
+
+    lmConcurrentHashMap_set(resource_manager->fonts, &font);
 }
 
 lmFont *lmResource_get_font(
@@ -88,25 +310,558 @@ lmFont *lmResource_get_font(
     char *name,
     lm_uint32 size
 ) {
-    return lmHashMap_get(
-        game->resource_manager->fonts, &(lmFont){.filepath=name, .size=size}
+    return lmResource_get_font_styled(game, name, size, TTF_STYLE_NORMAL);
+}
+
+lmFont *lmResource_get_font_styled(
+    lmGame *game,
+    char *name,
+    lm_uint32 size,
+    int style
+) {
+    return lmResource_get_font_by_id(game, lm_string_id(name), size, style);
+}
+
+lmFont *lmResource_get_font_by_id(
+    lmGame *game,
+    lmStringId id,
+    lm_uint32 size,
+    int style
+) {
+    return lmConcurrentHashMap_get(
+        game->resource_manager->fonts,
+        &(lmFont){.id=id, .size=size, .style=style}
     );
 }
 
+/*
+    Texture budget
+
+    Every texture ever loaded keeps its entry so pointers to it stay valid,
+    eviction only destroys the SDL texture. Unreferenced textures not used
+    this frame are evicted least recently used first.
+*/
+
+typedef struct {
+    lmTexture *texture;
+    lm_uint64 last_used;
+} _lmEvictionCandidate;
+
+static int _lm_eviction_compare(const void *a, const void *b) {
+    lm_uint64 la = ((const _lmEvictionCandidate *)a)->last_used;
+    lm_uint64 lb = ((const _lmEvictionCandidate *)b)->last_used;
+    return (la > lb) - (la < lb);
+}
+
+static void _lmResource_evict_textures(lmResourceManager *resource_manager) {
+    if (resource_manager->texture_budget == 0 ||
+        resource_manager->texture_bytes <= resource_manager->texture_budget)
+        return;
+
+    lmVec *candidates = lmVec_new(sizeof(_lmEvictionCandidate));
+    LM_MEMORY_ASSERT(candidates);
+
+    size_t iter = 0;
+    void *item;
+    while (lmConcurrentHashMap_iter(resource_manager->textures, &iter, &item)) {
+        lmTexture *texture = (lmTexture *)item;
+        lm_uint64 last_used = __atomic_load_n(&texture->last_used, __ATOMIC_RELAXED);
+
+        if (texture->sdl_texture &&
+            __atomic_load_n(&texture->refcount, __ATOMIC_ACQUIRE) == 0 &&
+            last_used != resource_manager->frame
+        ) {
+            _lmEvictionCandidate candidate = {texture, last_used};
+            LM_MEMORY_ASSERT(lmVec_push(candidates, &candidate));
+        }
+    }
+
+    qsort(candidates->data, candidates->size, sizeof(_lmEvictionCandidate), _lm_eviction_compare);
+
+    for (size_t i = 0; i < candidates->size; i++) {
+        if (resource_manager->texture_bytes <= resource_manager->texture_budget) break;
+
+        lmTexture *texture = LM_VEC_AT(candidates, _lmEvictionCandidate, i).texture;
+        SDL_DestroyTexture(texture->sdl_texture);
+        texture->sdl_texture = NULL;
+        resource_manager->texture_bytes -= texture->bytes;
+    }
+
+    lmVec_free(candidates);
+}
+
+/**
+ * @brief Add a loaded texture, or swap it into the existing entry of the same path.
+ */
+static lmTexture *_lmResource_store_texture(
+    lmResourceManager *resource_manager,
+    SDL_Texture *sdl_texture,
+    const char *filepath
+) {
+    lmStringId id = lm_intern_string(filepath);
+
+    lmTexture *texture = lmConcurrentHashMap_get(resource_manager->textures, &(lmTexture){.id=id});
+
+    // Update in place so references to the entry stay valid
+    if (texture) {
+        if (texture->sdl_texture) {
+            SDL_DestroyTexture(texture->sdl_texture);
+            resource_manager->texture_bytes -= texture->bytes;
+        }
+    }
+    else {
+        lmConcurrentHashMap_set(
+            resource_manager->textures,
+            &(lmTexture){.filepath=lm_string_id_lookup(id), .id=id, .refcount=0}
+        );
+        texture = lmConcurrentHashMap_get(resource_manager->textures, &(lmTexture){.id=id});
+        LM_MEMORY_ASSERT(texture);
+
+        _lmResource_watch(resource_manager, texture->filepath);
+    }
+
+    texture->sdl_texture = sdl_texture;
+    texture->bytes = lm_texture_bytes(sdl_texture);
+    texture->last_used = resource_manager->frame;
+    resource_manager->texture_bytes += texture->bytes;
+
+    _lmResource_evict_textures(resource_manager);
+
+    return texture;
+}
+
 void lmResource_load_texture(
     lmGame *game,
     char *filepath
 ) {
-    lmTexture texture = lmTexture_load(game->window, filepath);
+    SDL_Texture *sdl_texture = _lmResource_load_sdl_texture(game, filepath);
+    if (!sdl_texture) LM_ERROR(IMG_GetError());
 
-    lmHashMap_set(game->resource_manager->textures, &texture);
+    _lmResource_store_texture(game->resource_manager, sdl_texture, filepath);
 }
 
 lmTexture *lmResource_get_texture(
     lmGame *game,
     char *name
 ) {
-    return lmHashMap_get(
-        game->resource_manager->textures, &(lmTexture){.filepath=name}
+    return lmResource_get_texture_by_id(game, lm_string_id(name));
+}
+
+lmTexture *lmResource_get_texture_by_id(
+    lmGame *game,
+    lmStringId id
+) {
+    lmResourceManager *resource_manager = game->resource_manager;
+
+    lmTexture *texture = lmConcurrentHashMap_get(resource_manager->textures, &(lmTexture){.id=id});
+    if (!texture) return NULL;
+
+    lmResource_use_texture(game, texture);
+
+    return texture;
+}
+
+SDL_Texture *lmResource_use_texture(
+    lmGame *game,
+    lmTexture *texture
+) {
+    lmResourceManager *resource_manager = game->resource_manager;
+
+    __atomic_store_n(&texture->last_used, resource_manager->frame, __ATOMIC_RELAXED);
+
+    if (!texture->sdl_texture && SDL_ThreadID() == resource_manager->main_thread) {
+        SDL_Texture *sdl_texture = _lmResource_load_sdl_texture(game, texture->filepath);
+        if (!sdl_texture) LM_ERROR(IMG_GetError());
+
+        texture->sdl_texture = sdl_texture;
+        texture->bytes = lm_texture_bytes(sdl_texture);
+        resource_manager->texture_bytes += texture->bytes;
+
+        _lmResource_evict_textures(resource_manager);
+    }
+
+    return texture->sdl_texture;
+}
+
+lmTexture *lmResource_acquire_texture(
+    lmGame *game,
+    char *name
+) {
+    lmTexture *texture = lmResource_get_texture(game, name);
+    if (texture) __atomic_add_fetch(&texture->refcount, 1, __ATOMIC_ACQ_REL);
+
+    return texture;
+}
+
+void lmResource_release_texture(
+    lmGame *game,
+    lmTexture *texture
+) {
+    (void)game;
+    if (__atomic_fetch_sub(&texture->refcount, 1, __ATOMIC_ACQ_REL) == 0)
+        LM_ERROR("Texture released more times than it was acquired.");
+}
+
+
+/*
+    Asynchronous loading
+
+    Workers only do file IO and decoding, anything touching the renderer or
+    SDL_ttf runs on the main thread in lmResource_update.
+*/
+
+static void _lmResourceHandle_set_state(lmResourceHandle *handle, lmResourceState state) {
+    __atomic_store_n(&handle->state, state, __ATOMIC_RELEASE);
+}
+
+static void _lmResource_decode_job(void *data) {
+    lmResourceHandle *handle = (lmResourceHandle *)data;
+    lmResourceManager *resource_manager = (lmResourceManager *)handle->manager;
+    lmPack *pack = __atomic_load_n(&resource_manager->pack, __ATOMIC_ACQUIRE);
+    lmPackBlob blob;
+    bool in_pack = pack && lmPack_read(pack, handle->filepath, &blob);
+
+    if (handle->type == lmResourceType_TEXTURE) {
+        if (in_pack) {
+            SDL_RWops *rw = SDL_RWFromConstMem(blob.data, (int)blob.size);
+            handle->surface = rw ? IMG_Load_RW(rw, 1) : NULL;
+            lmPackBlob_free(&blob);
+        }
+        else {
+            handle->surface = IMG_Load(handle->filepath);
+        }
+
+        handle->failed = !handle->surface;
+    }
+    else {
+        // Uncompressed pack entries are left to be used in place on upload
+        if (in_pack) {
+            handle->file_data = blob.owned;
+            handle->file_size = blob.size;
+        }
+        else {
+            handle->file_data = SDL_LoadFile(handle->filepath, &handle->file_size);
+        }
+
+        handle->failed = !in_pack && !handle->file_data;
+    }
+
+    // Failed loads are queued too and marked on the main thread, so the
+    // handle isn't touched here after the main thread could free it.
+    if (!handle->failed) _lmResourceHandle_set_state(handle, lmResourceState_DECODED);
+
+    // Jobs run inline on the main thread when there are no workers, so
+    // this must never wait for lmResource_update to make room.
+    SDL_LockMutex(resource_manager->decoded_lock);
+    LM_MEMORY_ASSERT(lmVec_push(resource_manager->decoded, &handle));
+    SDL_UnlockMutex(resource_manager->decoded_lock);
+}
+
+static lmResourceHandle *_lmResource_load_async(
+    lmGame *game,
+    lmResourceType type,
+    const char *filepath,
+    lm_uint32 size,
+    bool reload
+) {
+    lmResourceHandle *handle = LM_NEW(lmResourceHandle);
+    LM_MEMORY_ASSERT(handle);
+
+    size_t filepath_len = strlen(filepath) + 1;
+    handle->filepath = LM_MALLOC(filepath_len);
+    LM_MEMORY_ASSERT(handle->filepath);
+    memcpy(handle->filepath, filepath, filepath_len);
+
+    handle->type = type;
+    handle->state = lmResourceState_LOADING;
+    handle->size = size;
+    handle->surface = NULL;
+    handle->file_data = NULL;
+    handle->file_size = 0;
+    handle->resource = NULL;
+    handle->manager = game->resource_manager;
+    handle->failed = false;
+    handle->reload = reload;
+    handle->released = reload;
+
+    lmArray_add(game->resource_manager->handles, handle);
+
+    // Other sizes of a loaded font share its data, nothing to read
+    if (!reload && type == lmResourceType_FONT && lmHashMap_get(
+        game->resource_manager->font_files, &(lmFontFile){.id=lm_string_id(filepath)}
+    )) {
+        handle->state = lmResourceState_DECODED;
+        LM_MEMORY_ASSERT(lmVec_push(game->resource_manager->uploads, &handle));
+        return handle;
+    }
+
+    lmThreadPool_submit(game->thread_pool, _lmResource_decode_job, handle);
+
+    return handle;
+}
+
+lmResourceHandle *lmResource_load_texture_async(
+    lmGame *game,
+    const char *filepath
+) {
+    return _lmResource_load_async(game, lmResourceType_TEXTURE, filepath, 0, false);
+}
+
+lmResourceHandle *lmResource_load_font_async(
+    lmGame *game,
+    const char *filepath,
+    lm_uint32 size
+) {
+    return _lmResource_load_async(game, lmResourceType_FONT, filepath, size, false);
+}
+
+/**
+ * @brief Reopen every font of a file from its new data. Returns `false` if any failed.
+ * 
+ * Either all of them switch to the new data or none do, the old data is
+ * freed once nothing uses it.
+ */
+static bool _lmResource_reload_font_file(
+    lmResourceManager *resource_manager,
+    const char *filepath,
+    void *data,
+    size_t data_size
+) {
+    lmFontFile *file = lmHashMap_get(
+        resource_manager->font_files, &(lmFontFile){.id=lm_string_id(filepath)}
     );
-}
\ No newline at end of file
+    if (!file || !data) {
+        SDL_free(data);
+        return false;
+    }
+
+    lmVec *fonts = lmVec_new(sizeof(lmFont *));
+    lmVec *ttfs = lmVec_new(sizeof(TTF_Font *));
+    LM_MEMORY_ASSERT(fonts && ttfs);
+
+    bool ok = true;
+    size_t iter = 0;
+    void *item;
+    while (lmConcurrentHashMap_iter(resource_manager->fonts, &iter, &item)) {
+        lmFont *font = (lmFont *)item;
+        if (font->id != file->id) continue;
+
+        lmFont new_font = lmFont_load_from_memory(
+            file->filepath, data, data_size, font->size, font->style
+        );
+        if (!new_font.ttf) {
+            ok = false;
+            break;
+        }
+
+        LM_MEMORY_ASSERT(lmVec_push(fonts, &font));
+        LM_MEMORY_ASSERT(lmVec_push(ttfs, &new_font.ttf));
+    }
+
+    if (ok) {
+        for (size_t i = 0; i < fonts->size; i++) {
+            lmFont *font = LM_VEC_AT(fonts, lmFont *, i);
+            TTF_CloseFont(font->ttf);
+            font->ttf = LM_VEC_AT(ttfs, TTF_Font *, i);
+        }
+
+        if (file->owned) SDL_free(file->data);
+        file->data = data;
+        file->size = data_size;
+        file->owned = true;
+    }
+    else {
+        for (size_t i = 0; i < ttfs->size; i++)
+            TTF_CloseFont(LM_VEC_AT(ttfs, TTF_Font *, i));
+        SDL_free(data);
+    }
+
+    lmVec_free(fonts);
+    lmVec_free(ttfs);
+
+    return ok;
+}
+
+/**
+ * @brief Finish loading a decoded resource. Returns the number of bytes uploaded.
+ */
+static size_t _lmResource_upload(lmGame *game, lmResourceHandle *handle) {
+    lmResourceManager *resource_manager = game->resource_manager;
+
+    if (handle->failed) {
+        _lmResourceHandle_set_state(handle, lmResourceState_FAILED);
+        return 0;
+    }
+
+    if (handle->type == lmResourceType_TEXTURE) {
+        size_t bytes = (size_t)handle->surface->pitch * (size_t)handle->surface->h;
+
+        SDL_Texture *sdl_texture = SDL_CreateTextureFromSurface(
+            game->window->sdl_renderer, handle->surface
+        );
+        SDL_FreeSurface(handle->surface);
+        handle->surface = NULL;
+
+        if (!sdl_texture) {
+            _lmResourceHandle_set_state(handle, lmResourceState_FAILED);
+            return bytes;
+        }
+
+        // Only the main thread renders, so a replaced texture can go now
+        handle->resource = _lmResource_store_texture(
+            resource_manager, sdl_texture, handle->filepath
+        );
+        _lmResourceHandle_set_state(handle, lmResourceState_READY);
+
+        return bytes;
+    }
+
+    else if (handle->reload) {
+        size_t bytes = handle->file_size;
+
+        bool reloaded = _lmResource_reload_font_file(
+            resource_manager, handle->filepath, handle->file_data, handle->file_size
+        );
+        handle->file_data = NULL;
+
+        _lmResourceHandle_set_state(
+            handle, reloaded ? lmResourceState_READY : lmResourceState_FAILED
+        );
+
+        return bytes;
+    }
+
+    else {
+        size_t bytes = handle->file_size;
+
+        lmFontFile *file = _lmResource_get_font_file(
+            resource_manager, handle->filepath, handle->file_data, handle->file_size
+        );
+        handle->file_data = NULL;
+
+        if (!file) {
+            _lmResourceHandle_set_state(handle, lmResourceState_FAILED);
+            return bytes;
+        }
+
+        lmFont font = lmFont_load_from_memory(
+            file->filepath, file->data, file->size, handle->size, TTF_STYLE_NORMAL
+        );
+
+        if (!font.ttf) {
+            _lmResourceHandle_set_state(handle, lmResourceState_FAILED);
+            return bytes;
+        }
+
+        // Update an existing entry in place so pointers to it stay valid
+        lmFont *old = lmConcurrentHashMap_get(resource_manager->fonts, &font);
+        if (old) {
+            TTF_CloseFont(old->ttf);
+            old->ttf = font.ttf;
+        }
+        else {
+            lmConcurrentHashMap_set(resource_manager->fonts, &font);
+        }
+
+        handle->resource = lmConcurrentHashMap_get(resource_manager->fonts, &font);
+        _lmResourceHandle_set_state(handle, lmResourceState_READY);
+
+        return bytes;
+    }
+}
+
+void lmResource_update(lmGame *game) {
+    lmResourceManager *resource_manager = game->resource_manager;
+
+    resource_manager->frame++;
+
+    // The budget may have been lowered since the last frame
+    _lmResource_evict_textures(resource_manager);
+
+    if (resource_manager->watcher) {
+        lmVec *changed = resource_manager->changed_files;
+        lmFileWatcher_poll(resource_manager->watcher, changed);
+
+        for (size_t i = 0; i < changed->size; i++) {
+            const char *filepath = LM_VEC_AT(changed, const char *, i);
+
+            lmStringId id = lm_string_id(filepath);
+
+            if (lmConcurrentHashMap_get(resource_manager->textures, &(lmTexture){.id=id}))
+                _lmResource_load_async(game, lmResourceType_TEXTURE, filepath, 0, true);
+
+            if (lmHashMap_get(resource_manager->font_files, &(lmFontFile){.id=id}))
+                _lmResource_load_async(game, lmResourceType_FONT, filepath, 0, true);
+        }
+
+        lmVec_clear(changed);
+    }
+
+    SDL_LockMutex(resource_manager->decoded_lock);
+    LM_MEMORY_ASSERT(lmVec_append(
+        resource_manager->uploads, resource_manager->decoded->data, resource_manager->decoded->size
+    ));
+    lmVec_clear(resource_manager->decoded);
+    SDL_UnlockMutex(resource_manager->decoded_lock);
+
+    lmVec *uploads = resource_manager->uploads;
+    if (uploads->size == 0) return;
+
+    // Always upload at least one so a resource bigger than the budget
+    // doesn't block the queue forever.
+    size_t spent = 0;
+    size_t done = 0;
+    while (done < uploads->size && (done == 0 || spent < resource_manager->upload_budget)) {
+        lmResourceHandle *upload = LM_VEC_AT(uploads, lmResourceHandle *, done);
+        spent += _lmResource_upload(game, upload);
+        done++;
+
+        // Nobody holds reload handles
+        if (upload->released) {
+            lmArray_remove(resource_manager->handles, upload);
+            _lmResourceHandle_free_data(upload);
+        }
+    }
+
+    // Keep the rest in load order for the next frame
+    memmove(
+        uploads->data,
+        &LM_VEC_AT(uploads, lmResourceHandle *, done),
+        sizeof(lmResourceHandle *) * (uploads->size - done)
+    );
+    uploads->size -= done;
+}
+
+lmResourceState lmResourceHandle_get_state(lmResourceHandle *handle) {
+    return __atomic_load_n(&handle->state, __ATOMIC_ACQUIRE);
+}
+
+lmTexture *lmResourceHandle_get_texture(lmResourceHandle *handle) {
+    if (handle->type != lmResourceType_TEXTURE ||
+        lmResourceHandle_get_state(handle) != lmResourceState_READY)
+        return NULL;
+
+    return (lmTexture *)handle->resource;
+}
+
+lmFont *lmResourceHandle_get_font(lmResourceHandle *handle) {
+    if (handle->type != lmResourceType_FONT ||
+        lmResourceHandle_get_state(handle) != lmResourceState_READY)
+        return NULL;
+
+    return (lmFont *)handle->resource;
+}
+
+void lmResourceHandle_free(lmGame *game, lmResourceHandle *handle) {
+    if (!handle) return;
+
+    // Only the main thread finishes loads, so the state can't change under us
+    lmResourceState state = lmResourceHandle_get_state(handle);
+    if (state != lmResourceState_READY && state != lmResourceState_FAILED) {
+        handle->released = true;
+        return;
+    }
+
+    lmArray_remove(game->resource_manager->handles, handle);
+    _lmResourceHandle_free_data(handle);
+}
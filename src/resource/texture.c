@@ -26,6 +26,18 @@ lmTexture lmTexture_load(lmWindow *window, const char *filepath) {
     if (!texture.sdl_texture) LM_ERROR(IMG_GetError());
 
     texture.filepath = filepath;
+    texture.id = lm_string_id(filepath);
+    texture.bytes = lm_texture_bytes(texture.sdl_texture);
+    texture.refcount = 0;
+    texture.last_used = 0;
 
     return texture;
+}
+
+size_t lm_texture_bytes(SDL_Texture *sdl_texture) {
+    int width = 0;
+    int height = 0;
+    SDL_QueryTexture(sdl_texture, NULL, NULL, &width, &height);
+
+    return (size_t)width * (size_t)height * 4;
 }
\ No newline at end of file